@@ -26,6 +26,7 @@ jfloat AverageFrametimeDeviationMs; //!< The average deviation of the average fr
 std::weak_ptr<skyline::kernel::OS> OsWeak;
 std::weak_ptr<skyline::gpu::GPU> GpuWeak;
 std::weak_ptr<skyline::input::Input> InputWeak;
+std::weak_ptr<skyline::trace::TraceRecorder> TraceRecorderWeak;
 
 // https://cs.android.com/android/platform/superproject/+/master:bionic/libc/tzcode/bionic.cpp;l=43;drc=master;bpv=1;bpt=1
 static std::string GetTimeZoneName() {
@@ -70,9 +71,17 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
     // Initialize tracing
     perfetto::TracingInitArgs args;
     args.backends |= perfetto::kSystemBackend;
+    if (settings->traceBufferSize)
+        args.backends |= perfetto::kInProcessBackend;
     perfetto::Tracing::Initialize(args);
     perfetto::TrackEvent::Register();
 
+    std::shared_ptr<skyline::trace::TraceRecorder> traceRecorder;
+    if (settings->traceBufferSize) {
+        traceRecorder = std::make_shared<skyline::trace::TraceRecorder>(settings->traceBufferSize);
+        TraceRecorderWeak = traceRecorder;
+    }
+
     try {
         auto os{std::make_shared<skyline::kernel::OS>(jvmManager, logger, settings, std::string(appFilesPath), GetTimeZoneName(), std::make_shared<skyline::vfs::AndroidAssetFileSystem>(AAssetManager_fromJava(env, assetManager)))};
         OsWeak = os;
@@ -96,6 +105,8 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
 
     perfetto::TrackEvent::Flush();
 
+    TraceRecorderWeak.reset();
+    traceRecorder.reset();
     InputWeak.reset();
 
     logger->InfoNoPrefix("Emulation has ended");
@@ -117,6 +128,24 @@ extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_stopEmulation(J
     return true;
 }
 
+extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_dumpTrace(JNIEnv *, jobject) {
+    auto traceRecorder{TraceRecorderWeak.lock()};
+    auto os{OsWeak.lock()};
+    if (!traceRecorder || !os)
+        return false;
+
+    auto path{skyline::util::Format("{}trace-{}.perfetto-trace", os->appFilesPath, std::time(nullptr))};
+    try {
+        traceRecorder->Dump(path);
+    } catch (const std::exception &e) {
+        os->state.logger->Warn("Failed to dump the trace: {}", e.what());
+        return false;
+    }
+
+    os->state.logger->Info("Wrote trace to '{}'", path);
+    return true;
+}
+
 extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_setSurface(JNIEnv *, jobject, jobject surface) {
     auto gpu{GpuWeak.lock()};
     if (!gpu)
@@ -20,7 +20,7 @@ extern "C" JNIEXPORT jint JNICALL Java_emu_skyline_loader_RomFile_populate(JNIEn
 
     std::unique_ptr<skyline::loader::Loader> loader;
     try {
-        auto backing{std::make_shared<skyline::vfs::OsBacking>(fd)};
+        auto backing{std::make_shared<skyline::vfs::OsBacking>(fd, false, skyline::vfs::Backing::Mode{true, false, false}, true)}; // The ROM is only mapped if no other application can truncate it
 
         switch (format) {
             case skyline::loader::RomFormat::NRO:
@@ -4,7 +4,7 @@
 #include "audio.h"
 
 namespace skyline::audio {
-    Audio::Audio(const DeviceState &state) : oboe::AudioStreamCallback() {
+    Audio::Audio(const DeviceState &state) : oboe::AudioStreamCallback(), levelTrack(trace::CreateTrack(trace::TrackIds::AudioBufferLevel, "Audio Buffer Level")) {
         builder.setChannelCount(constant::ChannelCount);
         builder.setSampleRate(constant::SampleRate);
         builder.setFormat(constant::PcmFormat);
@@ -42,6 +42,7 @@ namespace skyline::audio {
         auto destBuffer{static_cast<i16 *>(audioData)};
         auto streamSamples{static_cast<size_t>(numFrames) * audioStream->getChannelCount()};
         size_t writtenSamples{};
+        u64 queuedSamples{std::numeric_limits<u64>::max()}; //!< The lowest amount of queued samples in any playing track, this is the closest track to underrunning
 
         {
             std::lock_guard trackGuard(trackLock);
@@ -60,9 +61,14 @@ namespace skyline::audio {
 
                 track->sampleCounter += trackSamples;
                 track->CheckReleasedBuffers();
+
+                queuedSamples = std::min(queuedSamples, track->GetQueuedSamples());
             }
         }
 
+        if (queuedSamples != std::numeric_limits<u64>::max())
+            TRACE_EVENT_INSTANT("audio", "AudioBufferLevel", levelTrack, "QueuedSamples", queuedSamples, "UnderrunSamples", streamSamples - std::min(streamSamples, writtenSamples));
+
         if (streamSamples > writtenSamples)
             memset(destBuffer + writtenSamples, 0, (streamSamples - writtenSamples) * sizeof(i16));
 
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <common/trace.h>
 #include <audio/track.h>
 
 namespace skyline::audio {
@@ -15,6 +16,7 @@ namespace skyline::audio {
         oboe::ManagedStream outputStream;
         std::vector<std::shared_ptr<AudioTrack>> audioTracks;
         std::mutex trackLock; //!< Synchronizes modifications to the audio tracks
+        perfetto::Track levelTrack; //!< Perfetto track for the amount of queued samples, this is recorded on every callback
 
       public:
         Audio(const DeviceState &state);
@@ -20,7 +20,7 @@ namespace skyline::audio {
         u32 sampleRate;
 
       public:
-        CircularBuffer<i16, constant::SampleRate * constant::ChannelCount * 10> samples; //!< A circular buffer with all appended audio samples
+        CircularBuffer<i16, constant::SampleRate * constant::ChannelCount * 10> samples{accounting::Category::Audio}; //!< A circular buffer with all appended audio samples
         std::mutex bufferLock; //!< Synchronizes appending to audio buffers
 
         AudioOutState playbackState{AudioOutState::Stopped}; //!< The current state of playback
@@ -52,6 +52,14 @@ namespace skyline::audio {
          */
         bool ContainsBuffer(u64 tag);
 
+        /**
+         * @return The amount of samples which have been appended but haven't been played yet
+         * @note 'bufferLock' must be locked by the caller
+         */
+        u64 GetQueuedSamples() {
+            return identifiers.empty() ? 0 : identifiers.front().finalSample - std::min(identifiers.front().finalSample, sampleCounter);
+        }
+
         /**
          * @brief Gets the IDs of all newly released buffers
          * @param max The maximum amount of buffers to return
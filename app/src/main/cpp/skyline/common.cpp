@@ -9,6 +9,7 @@
 #include "audio.h"
 #include "input.h"
 #include "kernel/types/KThread.h"
+#include "kernel/profiler.h"
 
 namespace skyline {
     Logger::Logger(const std::string &path, LogLevel configLevel) : configLevel(configLevel), start(util::GetTimeNs() / constant::NsInMillisecond) {
@@ -55,5 +56,6 @@ namespace skyline {
         nce = std::make_shared<nce::NCE>(*this);
         scheduler = std::make_shared<kernel::Scheduler>(*this);
         input = std::make_shared<input::Input>(*this);
+        profiler = std::make_shared<kernel::Profiler>(*this);
     }
 }
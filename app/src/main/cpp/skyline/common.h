@@ -617,6 +617,7 @@ namespace skyline {
             class KThread;
         }
         class Scheduler;
+        class Profiler;
         class OS;
     }
     namespace audio {
@@ -649,5 +650,6 @@ namespace skyline {
         static thread_local inline std::shared_ptr<kernel::type::KThread> thread{}; //!< The KThread of the thread which accesses this object
         static thread_local inline nce::ThreadContext *ctx{}; //!< The context of the guest thread for the corresponding host thread
         std::shared_ptr<input::Input> input;
+        std::shared_ptr<kernel::Profiler> profiler; //!< This is destroyed prior to all other objects as its drain thread reads the sample buffers of guest threads, the profile is dumped by OS::Execute once the guest has exited
     };
 }
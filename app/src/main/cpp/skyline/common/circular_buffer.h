@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include <common.h>
+#include <common/memory_accounting.h>
 
 namespace skyline {
     /**
@@ -20,8 +20,14 @@ namespace skyline {
         Type *end{array.begin()}; //!< The end/newest element of the internal array
         bool empty{true}; //!< If the buffer is full or empty, as start == end can mean either
         std::mutex mtx; //!< Synchronizes buffer operations so they don't overlap
+        accounting::Allocation allocation; //!< The attribution of the internal array to the category of its contents
 
       public:
+        /**
+         * @param category The category the memory of the buffer is accounted under
+         */
+        CircularBuffer(accounting::Category category) : allocation(category, sizeof(array)) {}
+
         /**
          * @brief Reads data from this buffer into the specified buffer
          * @param copyFunction If this is specified, then this is called rather than memcpy
@@ -13,8 +13,8 @@ namespace skyline {
     class CircularQueue {
       private:
         std::vector<u8> vector; //!< The internal vector holding the circular queue's data, we use a byte vector due to the default item construction/destruction semantics not being appropriate for a circular buffer
-        Type *start{reinterpret_cast<Type *>(vector.begin().base())}; //!< The start/oldest element of the queue
-        Type *end{reinterpret_cast<Type *>(vector.begin().base())}; //!< The end/newest element of the queue
+        std::atomic<Type *> start{reinterpret_cast<Type *>(vector.begin().base())}; //!< The start/oldest element of the queue, this is only written by the consumer
+        std::atomic<Type *> end{reinterpret_cast<Type *>(vector.begin().base())}; //!< The end/newest element of the queue, this is only written by producers
         std::mutex consumptionMutex;
         std::condition_variable consumeCondition;
         std::mutex productionMutex;
@@ -31,8 +31,8 @@ namespace skyline {
         CircularQueue &operator=(const CircularQueue &) = delete;
 
         CircularQueue(CircularQueue &&other) : vector(std::move(other.vector)), consumptionMutex(std::move(other.consumptionMutex)), consumeCondition(std::move(other.consumeCondition)), productionMutex(std::move(other.productionMutex)), produceCondition(std::move(other.produceCondition)) {
-            start = other.start;
-            end = other.end;
+            start = other.start.load();
+            end = other.end.load();
             other.start = other.end = nullptr;
         }
 
@@ -45,6 +45,15 @@ namespace skyline {
             }
         }
 
+        /**
+         * @return The amount of items in the queue, this is only an estimate when the queue is being concurrently modified
+         */
+        size_t Size() {
+            Type *currentStart{start.load(std::memory_order_relaxed)}, *currentEnd{end.load(std::memory_order_relaxed)};
+            auto size{currentEnd - currentStart};
+            return static_cast<size_t>(size >= 0 ? size : size + static_cast<ssize_t>(vector.size() / sizeof(Type)));
+        }
+
         /**
          * @brief A blocking for-each that runs on every item and waits till new items to run on them as well
          * @param function A function that is called for each item (with the only parameter as a reference to that item)
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <bit>
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief A histogram of latencies with logarithmically sized buckets, recording a latency is lock-free and it can be read concurrently
+     * @note Bucket N holds all latencies within [2^(N-1), 2^N) nanoseconds while bucket 0 only holds latencies of 0 nanoseconds
+     */
+    class LatencyHistogram {
+      public:
+        static constexpr size_t BucketCount{40}; //!< The amount of buckets, the last bucket holds all latencies above ~9 minutes
+
+        /**
+         * @brief A non-atomic copy of a histogram, it's used to merge and analyze histograms
+         */
+        struct Snapshot {
+            u64 count{}; //!< The amount of latencies recorded
+            u64 total{}; //!< The sum of all latencies recorded in nanoseconds
+            u64 max{}; //!< The highest latency recorded in nanoseconds
+            std::array<u64, BucketCount> buckets{};
+
+            void Merge(const Snapshot &other) {
+                count += other.count;
+                total += other.total;
+                max = std::max(max, other.max);
+                for (size_t bucket{}; bucket < BucketCount; bucket++)
+                    buckets[bucket] += other.buckets[bucket];
+            }
+
+            u64 Mean() const {
+                return count ? total / count : 0;
+            }
+
+            /**
+             * @return An upper bound of the latency at the supplied percentile (0-100) in nanoseconds, this is limited by the resolution of the buckets
+             */
+            u64 Percentile(double percentile) const {
+                auto target{static_cast<u64>(static_cast<double>(count) * percentile / 100.0)};
+                u64 cumulative{};
+                for (size_t bucket{}; bucket < BucketCount; bucket++) {
+                    cumulative += buckets[bucket];
+                    if (cumulative > target || cumulative == count)
+                        return std::min(bucket ? (1ULL << bucket) - 1 : 0, max);
+                }
+                return max;
+            }
+        };
+
+      private:
+        std::atomic<u64> count{};
+        std::atomic<u64> total{};
+        std::atomic<u64> max{};
+        std::array<std::atomic<u64>, BucketCount> buckets{};
+
+      public:
+        void Record(u64 latency) {
+            buckets[std::min<size_t>(std::bit_width(latency), BucketCount - 1)].fetch_add(1, std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+            total.fetch_add(latency, std::memory_order_relaxed);
+
+            auto currentMax{max.load(std::memory_order_relaxed)};
+            while (latency > currentMax && !max.compare_exchange_weak(currentMax, latency, std::memory_order_relaxed));
+        }
+
+        Snapshot GetSnapshot() const {
+            Snapshot snapshot{
+                .count = count.load(std::memory_order_relaxed),
+                .total = total.load(std::memory_order_relaxed),
+                .max = max.load(std::memory_order_relaxed),
+            };
+            for (size_t bucket{}; bucket < BucketCount; bucket++)
+                snapshot.buckets[bucket] = buckets[bucket].load(std::memory_order_relaxed);
+            return snapshot;
+        }
+    };
+}
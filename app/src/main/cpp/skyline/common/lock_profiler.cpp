@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "lock_profiler.h"
+
+#ifdef SKYLINE_LOCK_PROFILING
+
+namespace skyline {
+    void LockSite::Dump(Logger &logger, size_t count) {
+        std::vector<LockSite *> sites;
+        for (auto site{head.load(std::memory_order_acquire)}; site; site = site->next)
+            if (site->acquisitions.load(std::memory_order_relaxed))
+                sites.push_back(site);
+
+        count = std::min(count, sites.size());
+        std::partial_sort(sites.begin(), sites.begin() + count, sites.end(), [](LockSite *a, LockSite *b) {
+            return a->waitTime.load(std::memory_order_relaxed) > b->waitTime.load(std::memory_order_relaxed);
+        });
+
+        std::string statistics;
+        for (auto site : span(sites).first(count)) {
+            auto acquisitions{site->acquisitions.load(std::memory_order_relaxed)}, contentions{site->contentions.load(std::memory_order_relaxed)};
+            auto waitTime{site->waitTime.load(std::memory_order_relaxed)};
+            statistics += fmt::format("\n* {}: {} acquisitions, {} contended ({:.2f}%), Wait: {:.3f}ms (Mean: {}ns), Hold: {:.3f}ms", site->name, acquisitions, contentions, static_cast<double>(contentions) * 100.0 / static_cast<double>(acquisitions), static_cast<double>(waitTime) / constant::NsInMillisecond, contentions ? waitTime / contentions : 0, static_cast<double>(site->holdTime.load(std::memory_order_relaxed)) / constant::NsInMillisecond);
+        }
+
+        if (!statistics.empty())
+            logger.Info("Lock Contention:{}", statistics);
+    }
+}
+
+#endif
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <shared_mutex>
+#include <condition_variable>
+#include <common.h>
+
+namespace skyline {
+    #ifdef SKYLINE_LOCK_PROFILING
+
+    /**
+     * @brief Contention statistics for all locks declared at a single site in the source, these are updated lock-free
+     * @note Sites are never destroyed and are linked into a global list when they're constructed so they can all be reported
+     */
+    struct LockSite {
+        const char *name;
+        std::atomic<u64> acquisitions{};
+        std::atomic<u64> contentions{}; //!< The amount of acquisitions which had to wait for the lock to be released
+        std::atomic<u64> waitTime{}; //!< The total time spent waiting on contended acquisitions in nanoseconds
+        std::atomic<u64> holdTime{}; //!< The total time the lock was held exclusively in nanoseconds
+        LockSite *next; //!< The next site in the list of all sites
+
+        inline static std::atomic<LockSite *> head{}; //!< The most recently constructed site
+
+        LockSite(const char *name) : name(name), next(head.load(std::memory_order_relaxed)) {
+            while (!head.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        void RecordAcquisition() {
+            acquisitions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void RecordContention(u64 wait) {
+            acquisitions.fetch_add(1, std::memory_order_relaxed);
+            contentions.fetch_add(1, std::memory_order_relaxed);
+            waitTime.fetch_add(wait, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Logs the sites with the most time spent waiting on them
+         * @param count The maximum amount of sites to log
+         */
+        static void Dump(Logger &logger, size_t count = 16);
+    };
+
+    /**
+     * @brief A wrapper around a mutex which records acquisitions, contention and hold times into a LockSite
+     * @note Acquisitions are only timed when the lock is contended, an uncontended acquisition costs a single try_lock
+     */
+    template<typename MutexType>
+    class InstrumentedMutex {
+      protected:
+        MutexType mutex;
+        LockSite &site;
+        u64 lockTimestamp{}; //!< The time at which the lock was exclusively acquired, this is only accessed by the exclusive owner
+
+      public:
+        InstrumentedMutex(LockSite &site) : site(site) {}
+
+        void lock() {
+            if (mutex.try_lock()) {
+                site.RecordAcquisition();
+            } else {
+                auto start{util::GetTimeNs()};
+                mutex.lock();
+                site.RecordContention(util::GetTimeNs() - start);
+            }
+            lockTimestamp = util::GetTimeNs();
+        }
+
+        bool try_lock() {
+            if (!mutex.try_lock())
+                return false;
+            site.RecordAcquisition();
+            lockTimestamp = util::GetTimeNs();
+            return true;
+        }
+
+        void unlock() {
+            auto holdTime{util::GetTimeNs() - lockTimestamp};
+            mutex.unlock();
+            site.holdTime.fetch_add(holdTime, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief An instrumented std::shared_mutex, shared acquisitions are counted and timed alongside exclusive ones but their hold time isn't recorded
+     */
+    class InstrumentedSharedMutex : public InstrumentedMutex<std::shared_mutex> {
+      public:
+        using InstrumentedMutex::InstrumentedMutex;
+
+        void lock_shared() {
+            if (mutex.try_lock_shared()) {
+                site.RecordAcquisition();
+            } else {
+                auto start{util::GetTimeNs()};
+                mutex.lock_shared();
+                site.RecordContention(util::GetTimeNs() - start);
+            }
+        }
+
+        bool try_lock_shared() {
+            if (!mutex.try_lock_shared())
+                return false;
+            site.RecordAcquisition();
+            return true;
+        }
+
+        void unlock_shared() {
+            mutex.unlock_shared();
+        }
+    };
+
+    using ProfiledMutex = InstrumentedMutex<std::mutex>;
+    using ProfiledSharedMutex = InstrumentedSharedMutex;
+    using ProfiledConditionVariable = std::condition_variable_any; //!< A condition variable which can be used with a ProfiledMutex
+
+    /**
+     * @brief Supplies the LockSite for the name as the initializer of a ProfiledMutex or ProfiledSharedMutex
+     * @note Every expansion has its own site, the site is shared by all instances of a lock declared with it
+     */
+    #define LOCK_SITE(name) []() -> ::skyline::LockSite & { static ::skyline::LockSite site{name}; return site; }()
+
+    #else
+
+    using ProfiledMutex = std::mutex;
+    using ProfiledSharedMutex = std::shared_mutex;
+    using ProfiledConditionVariable = std::condition_variable;
+
+    #define LOCK_SITE(name)
+
+    #endif
+}
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "trace.h"
+#include "memory_accounting.h"
+
+namespace skyline::accounting {
+    namespace {
+        struct Counter {
+            std::atomic<u64> live{};
+            std::atomic<u64> peak{};
+        };
+
+        std::array<Counter, static_cast<size_t>(Category::Count)> counters{};
+
+        /**
+         * @return The Perfetto track for the supplied category, these are only created on the first change in usage as tracing must be initialized prior to that
+         */
+        const perfetto::Track &GetTrack(Category category) {
+            static const std::vector<perfetto::Track> tracks{[]() {
+                std::vector<perfetto::Track> tracks;
+                for (size_t index{}; index < CategoryNames.size(); index++)
+                    tracks.push_back(trace::CreateTrack(trace::TrackIds::MemoryCategory, CategoryNames[index], index));
+                return tracks;
+            }()};
+            return tracks[static_cast<size_t>(category)];
+        }
+    }
+
+    void Allocate(Category category, size_t size) {
+        auto &counter{counters[static_cast<size_t>(category)]};
+        auto live{counter.live.fetch_add(size, std::memory_order_relaxed) + size};
+
+        auto peak{counter.peak.load(std::memory_order_relaxed)};
+        while (live > peak && !counter.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+
+        TRACE_EVENT_INSTANT("memory", "MemoryUsage", GetTrack(category), "Live", live);
+    }
+
+    void Free(Category category, size_t size) {
+        auto live{counters[static_cast<size_t>(category)].live.fetch_sub(size, std::memory_order_relaxed) - size};
+        TRACE_EVENT_INSTANT("memory", "MemoryUsage", GetTrack(category), "Live", live);
+    }
+
+    std::array<Usage, static_cast<size_t>(Category::Count)> GetSnapshot() {
+        std::array<Usage, static_cast<size_t>(Category::Count)> snapshot{};
+        for (size_t index{}; index < snapshot.size(); index++)
+            snapshot[index] = {
+                .live = counters[index].live.load(std::memory_order_relaxed),
+                .peak = counters[index].peak.load(std::memory_order_relaxed),
+            };
+        return snapshot;
+    }
+
+    void Dump(Logger &logger) {
+        auto snapshot{GetSnapshot()};
+
+        std::string usage;
+        for (size_t index{}; index < snapshot.size(); index++)
+            if (snapshot[index].peak)
+                usage += fmt::format("\n* {}: Live: {:.2f} MiB, Peak: {:.2f} MiB", CategoryNames[index], static_cast<double>(snapshot[index].live) / 0x100000, static_cast<double>(snapshot[index].peak) / 0x100000);
+
+        if (!usage.empty())
+            logger.Info("Host Memory Usage:{}", usage);
+    }
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::accounting {
+    /**
+     * @brief The subsystems that host memory is attributed to, allocation sites tag their memory with one of these
+     */
+    enum class Category : u8 {
+        GuestPrivate, //!< Private guest memory (KPrivateMemory), this is the mapped size as pages are only committed when they're first accessed
+        GuestShared, //!< The host mirrors of shared memory (KSharedMemory) aside from the ones attributed to other categories
+        Fonts, //!< The shared font data supplied to the guest
+        GpuDeviceLocal, //!< Device-local Vulkan memory blocks allocated by VMA, images reside in these
+        GpuHostVisible, //!< Host-visible Vulkan memory blocks allocated by VMA, staging buffers reside in these
+        Audio, //!< Buffers of audio samples which are pending playback
+        Loader, //!< Executable segments which have been read and decompressed prior to being loaded into guest memory
+        FileCache, //!< Blocks of file data cached by CachedBacking
+        Count,
+    };
+
+    constexpr std::array<const char *, static_cast<size_t>(Category::Count)> CategoryNames{
+        "Guest Private Memory",
+        "Guest Shared Memory",
+        "Fonts",
+        "GPU Device-Local Memory",
+        "GPU Host-Visible Memory",
+        "Audio Buffers",
+        "Loader Buffers",
+        "File Cache",
+    };
+
+    /**
+     * @brief The memory usage of a single category in bytes
+     */
+    struct Usage {
+        u64 live; //!< The amount of memory that's currently allocated
+        u64 peak; //!< The highest amount of memory that's been allocated at once
+    };
+
+    /**
+     * @brief Attributes an allocation of the supplied size to a category
+     */
+    void Allocate(Category category, size_t size);
+
+    /**
+     * @brief Removes an allocation which was previously attributed to a category
+     */
+    void Free(Category category, size_t size);
+
+    /**
+     * @return The current usage of every category, this can be called at any time from any thread
+     */
+    std::array<Usage, static_cast<size_t>(Category::Count)> GetSnapshot();
+
+    /**
+     * @brief Logs the live and peak usage of every category which has been used
+     */
+    void Dump(Logger &logger);
+
+    /**
+     * @brief An RAII wrapper around the attribution of an allocation to a category, this is meant to be a member of an object owning the memory
+     */
+    class Allocation {
+      private:
+        Category category;
+        size_t size{};
+
+      public:
+        Allocation(Category category, size_t size = 0) : category(category), size(size) {
+            if (size)
+                Allocate(category, size);
+        }
+
+        Allocation(const Allocation &) = delete;
+
+        Allocation &operator=(const Allocation &) = delete;
+
+        Allocation(Allocation &&other) : category(other.category), size(std::exchange(other.size, 0)) {}
+
+        Allocation &operator=(Allocation &&other) {
+            if (this != &other) {
+                Resize(0);
+                category = other.category;
+                size = std::exchange(other.size, 0);
+            }
+            return *this;
+        }
+
+        ~Allocation() {
+            if (size)
+                Free(category, size);
+        }
+
+        /**
+         * @brief Changes the size of the allocation, the difference is attributed to or removed from the category
+         */
+        void Resize(size_t newSize) {
+            if (newSize > size)
+                Allocate(category, newSize - size);
+            else if (newSize < size)
+                Free(category, size - newSize);
+            size = newSize;
+        }
+
+        /**
+         * @brief Moves the allocation to a different category, this is used when the purpose of memory is only known after it's been allocated
+         */
+        void SetCategory(Category newCategory) {
+            if (size) {
+                Free(category, size);
+                Allocate(newCategory, size);
+            }
+            category = newCategory;
+        }
+    };
+}
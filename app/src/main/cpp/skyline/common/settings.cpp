@@ -23,6 +23,13 @@ namespace skyline {
             PREF_ELEM("disable_frame_throttling", disableFrameThrottling, element.attribute("value").as_bool()),
         };
 
+        // Preferences which were added after the initial release aren't written to the file of an existing install till they're changed in the settings, they retain their default values when missing
+        std::tuple optionalPreferences{
+            PREF_ELEM("profiler_frequency", profilerFrequency, element.text().as_uint()),
+            PREF_ELEM("trace_buffer_size", traceBufferSize, element.text().as_uint()),
+            PREF_ELEM("romfs_cache_size", romFsCacheSize, element.text().as_uint()),
+        };
+
         #undef PREF_ELEM
 
         std::bitset<std::tuple_size_v<typeof(preferences)>> preferencesSet{}; // A bitfield to keep track of all the preferences we've set
@@ -38,6 +45,12 @@ namespace skyline {
                     index++;
                 }(preferences), ...);
             }, preferences);
+            std::apply([&](auto... preferences) {
+                ([&](auto preference) {
+                    if (name == preference.first)
+                        preference.second(*this, element);
+                }(preferences), ...);
+            }, optionalPreferences);
         }
 
         if (!preferencesSet.all()) {
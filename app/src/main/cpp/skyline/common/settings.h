@@ -16,6 +16,9 @@ namespace skyline {
         bool operationMode; //!< If the emulated Switch should be handheld or docked
         bool forceTripleBuffering; //!< If the presentation engine should always triple buffer even if the swapchain supports double buffering
         bool disableFrameThrottling; //!< Allow the guest to submit frames without any blocking calls
+        u32 profilerFrequency{}; //!< The frequency in Hz at which guest threads are sampled by the profiler, 0 disables the profiler
+        u32 traceBufferSize{}; //!< The size of the in-process trace ring buffer in KiB, 0 disables in-process tracing
+        u32 romFsCacheSize{}; //!< The memory budget of the cache for decrypted RomFS data in MiB, 0 disables caching
 
         /**
          * @param fd An FD to the preference XML file
@@ -1,3 +1,40 @@
 #include "trace.h"
 
 PERFETTO_TRACK_EVENT_STATIC_STORAGE(); //!< Expands into a structure with static storage for all track events
+
+namespace skyline::trace {
+    TraceRecorder::TraceRecorder(u32 bufferSize) : bufferSize(bufferSize) {
+        std::lock_guard guard(mutex);
+        Start();
+    }
+
+    TraceRecorder::~TraceRecorder() {
+        std::lock_guard guard(mutex);
+        perfetto::TrackEvent::Flush();
+        session->StopBlocking();
+    }
+
+    void TraceRecorder::Start() {
+        perfetto::TraceConfig config;
+        auto buffer{config.add_buffers()};
+        buffer->set_size_kb(bufferSize);
+        buffer->set_fill_policy(perfetto::TraceConfig::BufferConfig::RING_BUFFER);
+        config.add_data_sources()->mutable_config()->set_name("track_event");
+
+        session = perfetto::Tracing::NewTrace(perfetto::kInProcessBackend);
+        session->Setup(config);
+        session->StartBlocking();
+    }
+
+    void TraceRecorder::Dump(const std::string &path) {
+        std::lock_guard guard(mutex);
+        perfetto::TrackEvent::Flush();
+        session->StopBlocking();
+        auto trace{session->ReadTraceBlocking()};
+        Start();
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.write(trace.data(), static_cast<std::streamsize>(trace.size())))
+            throw exception("Failed to write trace to '{}'", path);
+    }
+}
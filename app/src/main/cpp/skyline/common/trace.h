@@ -13,6 +13,8 @@ PERFETTO_DEFINE_CATEGORIES(
     perfetto::Category("kernel").SetDescription("Events from parts of the HLE kernel"),
     perfetto::Category("guest").SetDescription("Events relating to guest code"),
     perfetto::Category("gpu").SetDescription("Events from the emulated GPU"),
+    perfetto::Category("audio").SetDescription("Events from the audio output"),
+    perfetto::Category("memory").SetDescription("Changes in host memory usage by subsystem"),
     perfetto::Category("service").SetDescription("Events from the HLE sysmodule implementations")
 );
 
@@ -22,5 +24,53 @@ namespace skyline::trace {
      */
     enum class TrackIds : u64 {
         Presentation = std::numeric_limits<u64>::max(),
+        GpfifoDepth = std::numeric_limits<u64>::max() - 1,
+        AudioBufferLevel = std::numeric_limits<u64>::max() - 2,
+        SchedulerCore = std::numeric_limits<u64>::max() - 3, //!< The track of core 0, the tracks of subsequent cores count down from this
+        MemoryCategory = std::numeric_limits<u64>::max() - 0x10, //!< The track of the first memory accounting category, the tracks of subsequent categories count down from this
+    };
+
+    /**
+     * @brief Creates a process-scoped custom track and sets its name in the trace
+     * @param offset An offset to count down from the ID by, this is used to create a series of tracks
+     */
+    inline perfetto::Track CreateTrack(TrackIds id, const std::string &name, u64 offset = 0) {
+        perfetto::Track track(static_cast<u64>(id) - offset, perfetto::ProcessTrack::Current());
+        auto desc{track.Serialize()};
+        desc.set_name(name);
+        perfetto::TrackEvent::SetTrackDescriptor(track, desc);
+        return track;
+    }
+
+    /**
+     * @brief An in-process tracing session which continuously records all track events into a ring buffer, this allows capturing a trace of the last few seconds after an issue such as a stutter occurs
+     * @note The memory usage is bounded by the size of the ring buffer as older events are overwritten by newer ones
+     */
+    class TraceRecorder {
+      private:
+        std::mutex mutex; //!< Synchronizes starting, stopping and reading the session
+        std::unique_ptr<perfetto::TracingSession> session;
+        u32 bufferSize; //!< The size of the ring buffer in KiB
+
+        /**
+         * @brief Starts a new session with an empty ring buffer
+         * @note 'mutex' must be locked by the caller
+         */
+        void Start();
+
+      public:
+        /**
+         * @param bufferSize The size of the ring buffer in KiB
+         * @note The in-process backend must've been initialized prior to this
+         */
+        TraceRecorder(u32 bufferSize);
+
+        ~TraceRecorder();
+
+        /**
+         * @brief Writes the contents of the ring buffer to a file in the Perfetto trace format, recording resumes into an empty ring buffer afterwards
+         * @note There's a small gap in recording while the trace is being read as the session must be stopped to be read
+         */
+        void Dump(const std::string &path);
     };
 }
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "worker_pool.h"
+
+namespace skyline {
+    WorkerPool::WorkerPool(size_t threadCount) {
+        threads.reserve(threadCount);
+        for (size_t index{}; index < threadCount; index++)
+            threads.emplace_back(&WorkerPool::Run, this);
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard lock(mutex);
+            exiting = true;
+        }
+        condition.notify_all();
+
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    WorkerPool &WorkerPool::Get() {
+        static WorkerPool pool{std::max(std::thread::hardware_concurrency(), 2U) - 1};
+        return pool;
+    }
+
+    void WorkerPool::Run() {
+        pthread_setname_np(pthread_self(), "Sky-Worker");
+
+        std::unique_lock lock(mutex);
+        while (true) {
+            condition.wait(lock, [this]() { return !jobs.empty() || exiting; });
+            if (jobs.empty())
+                return;
+
+            auto job{std::move(jobs.front())};
+            jobs.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+    }
+
+    void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)> &function) {
+        /**
+         * @brief The state of a single ParallelFor call, it's shared with the queued jobs as they may only be dequeued after the call has returned
+         */
+        struct Operation {
+            const std::function<void(size_t)> &function; //!< This is only called while the caller is blocked so the reference stays valid
+            size_t count;
+            std::atomic<size_t> next{}; //!< The next index to be picked up
+            std::atomic<size_t> completed{}; //!< The amount of indices which have been picked up and returned or skipped
+            std::exception_ptr exception; //!< The first exception thrown by any call, this is guarded by 'mutex'
+            std::mutex mutex;
+            std::condition_variable condition; //!< Signalled when all indices have been completed
+
+            Operation(const std::function<void(size_t)> &function, size_t count) : function(function), count(count) {}
+
+            /**
+             * @brief Picks up and runs indices till there are none left
+             */
+            void Work() {
+                size_t index;
+                while ((index = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+                    try {
+                        function(index);
+                    } catch (...) {
+                        {
+                            std::lock_guard lock(mutex);
+                            if (!exception)
+                                exception = std::current_exception();
+                        }
+
+                        // All indices which haven't been picked up yet are skipped, they're counted as completed on behalf of them
+                        auto skipped{next.exchange(count, std::memory_order_relaxed)};
+                        if (skipped < count)
+                            Complete(count - skipped);
+                    }
+                    Complete(1);
+                }
+            }
+
+            void Complete(size_t amount) {
+                if (completed.fetch_add(amount, std::memory_order_acq_rel) + amount == count) {
+                    std::lock_guard lock(mutex);
+                    condition.notify_all();
+                }
+            }
+        };
+
+        if (count <= 1 || threads.empty()) {
+            for (size_t index{}; index < count; index++)
+                function(index);
+            return;
+        }
+
+        auto operation{std::make_shared<Operation>(function, count)};
+        {
+            std::lock_guard lock(mutex);
+            for (size_t worker{}; worker < std::min(count - 1, threads.size()); worker++)
+                jobs.emplace_back([operation]() { operation->Work(); });
+        }
+        condition.notify_all();
+
+        operation->Work();
+
+        std::unique_lock lock(operation->mutex);
+        operation->condition.wait(lock, [&]() { return operation->completed.load(std::memory_order_acquire) == count; });
+        if (operation->exception)
+            std::rethrow_exception(operation->exception);
+    }
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief A pool of worker threads which large operations such as decryption, patching and loading are split across, this avoids the cost of creating threads for every operation
+     */
+    class WorkerPool {
+      private:
+        std::mutex mutex; //!< Synchronizes all accesses to 'jobs' and 'exiting'
+        std::condition_variable condition; //!< Signalled when jobs have been queued or the pool is being destroyed
+        std::deque<std::function<void()>> jobs;
+        std::vector<std::thread> threads;
+        bool exiting{};
+
+        void Run();
+
+      public:
+        /**
+         * @param threadCount The amount of worker threads, the thread calling ParallelFor does work as well so this should be one less than the desired parallelism
+         */
+        WorkerPool(size_t threadCount);
+
+        ~WorkerPool();
+
+        /**
+         * @return A process-wide pool with a worker thread for every CPU core aside from one
+         */
+        static WorkerPool &Get();
+
+        /**
+         * @return The amount of threads work can be split across, this includes the calling thread
+         */
+        size_t Parallelism() {
+            return threads.size() + 1;
+        }
+
+        /**
+         * @brief Calls the function with every index in [0, count) across the worker threads and the calling thread, this blocks till all calls have returned
+         * @note The calling thread keeps picking up indices itself so this completes even if all workers are busy with other operations
+         * @note As the calling thread never waits on indices which haven't been picked up, this may be called from within a function running on the pool
+         * @note If any call throws, the remaining indices are skipped and the first exception is rethrown on the calling thread after all calls in flight have returned
+         */
+        void ParallelFor(size_t count, const std::function<void(size_t)> &function);
+    };
+}
@@ -1,9 +1,27 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include "aes_hardware.h"
+#include <common/worker_pool.h>
 #include "aes_cipher.h"
 
 namespace skyline::crypto {
+    namespace {
+        constexpr size_t ParallelThreshold{0x100000}; //!< The minimum size of data for it to be decrypted across multiple threads
+
+        /**
+         * @return The tweak for the next block, this is a multiplication by x in GF(2^128) with the tweak being a little-endian 128-bit integer
+         */
+        uint8x16_t MultiplyTweak(uint8x16_t tweak) {
+            auto tweak64{vreinterpretq_u64_u8(tweak)};
+            u64 low{vgetq_lane_u64(tweak64, 0)}, high{vgetq_lane_u64(tweak64, 1)};
+            u64 reduction{(high >> 63) * 0x87};
+            high = (high << 1) | (low >> 63);
+            low = (low << 1) ^ reduction;
+            return vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(low), vcreate_u64(high)));
+        }
+    }
+
     AesCipher::AesCipher(span<u8> key, mbedtls_cipher_type_t type) {
         mbedtls_cipher_init(&decryptContext);
         if (mbedtls_cipher_setup(&decryptContext, mbedtls_cipher_info_from_type(type)) != 0)
@@ -11,10 +29,29 @@ namespace skyline::crypto {
 
         if (mbedtls_cipher_setkey(&decryptContext, key.data(), key.size() * 8, MBEDTLS_DECRYPT) != 0)
             throw exception("Failed to set key for decryption context");
+
+        if (type == MBEDTLS_CIPHER_AES_128_XTS) {
+            xts = true;
+            mbedtls_aes_xts_init(&xtsContext);
+            if (mbedtls_aes_xts_setkey_dec(&xtsContext, key.data(), key.size() * 8) != 0)
+                throw exception("Failed to set key for XTS decryption context");
+
+            hardware = hardware::IsSupported();
+            if (hardware) {
+                // The first half of the key is used for the data while the second half is used for the tweak
+                std::array<u8, BlockSize> dataKey, tweakKey;
+                std::memcpy(dataKey.data(), key.data(), BlockSize);
+                std::memcpy(tweakKey.data(), key.data() + BlockSize, BlockSize);
+                dataKeys = hardware::ExpandDecryptionKey(hardware::ExpandEncryptionKey(dataKey));
+                tweakKeys = hardware::ExpandEncryptionKey(tweakKey);
+            }
+        }
     }
 
     AesCipher::~AesCipher() {
         mbedtls_cipher_free(&decryptContext);
+        if (xts)
+            mbedtls_aes_xts_free(&xtsContext);
     }
 
     void AesCipher::SetIV(const std::array<u8, 0x10> &iv) {
@@ -60,13 +97,74 @@ namespace skyline::crypto {
             std::memcpy(destination, buffer.data(), size);
     }
 
+    void AesCipher::XtsDecryptHardware(u8 *destination, const u8 *source, size_t size, size_t sector, size_t sectorSize) const {
+        auto decryptionKeys{hardware::LoadKeys(dataKeys)}, encryptionKeys{hardware::LoadKeys(tweakKeys)};
+
+        for (; size; size -= sectorSize, sector++) {
+            auto initialTweak{GetTweak(sector)};
+            auto tweak{hardware::EncryptBlock(vld1q_u8(initialTweak.data()), encryptionKeys)};
+
+            size_t remaining{sectorSize};
+            for (; remaining >= BlockSize * 4; remaining -= BlockSize * 4, destination += BlockSize * 4, source += BlockSize * 4) {
+                std::array<uint8x16_t, 4> tweaks, states;
+                for (size_t index{}; index < states.size(); index++) {
+                    tweaks[index] = tweak;
+                    states[index] = veorq_u8(vld1q_u8(source + (index * BlockSize)), tweak);
+                    tweak = MultiplyTweak(tweak);
+                }
+
+                hardware::DecryptBlocks(states, decryptionKeys);
+
+                for (size_t index{}; index < states.size(); index++)
+                    vst1q_u8(destination + (index * BlockSize), veorq_u8(states[index], tweaks[index]));
+            }
+
+            for (; remaining; remaining -= BlockSize, destination += BlockSize, source += BlockSize) {
+                vst1q_u8(destination, veorq_u8(hardware::DecryptBlock(veorq_u8(vld1q_u8(source), tweak), decryptionKeys), tweak));
+                tweak = MultiplyTweak(tweak);
+            }
+        }
+    }
+
+    void AesCipher::XtsDecryptSoftware(u8 *destination, const u8 *source, size_t size, size_t sector, size_t sectorSize) const {
+        for (size_t offset{}; offset < size; offset += sectorSize) {
+            auto tweak{GetTweak(sector++)};
+            if (mbedtls_aes_crypt_xts(&xtsContext, MBEDTLS_AES_DECRYPT, sectorSize, tweak.data(), source + offset, destination + offset) != 0)
+                throw exception("Failed to decrypt XTS sector 0x{:X}", sector - 1);
+        }
+    }
+
     void AesCipher::XtsDecrypt(u8 *destination, u8 *source, size_t size, size_t sector, size_t sectorSize) {
         if (size % sectorSize)
             throw exception("Size must be multiple of sector size");
 
-        for (size_t i{}; i < size; i += sectorSize) {
-            SetIV(GetTweak(sector++));
-            Decrypt(destination + i, source + i, sectorSize);
+        if (!xts || sectorSize % BlockSize) {
+            for (size_t i{}; i < size; i += sectorSize) {
+                SetIV(GetTweak(sector++));
+                Decrypt(destination + i, source + i, sectorSize);
+            }
+            return;
         }
+
+        auto transform{hardware ? &AesCipher::XtsDecryptHardware : &AesCipher::XtsDecryptSoftware};
+
+        // Sectors are independent of each other, so large buffers are split into runs of sectors which are decrypted concurrently
+        auto &pool{WorkerPool::Get()};
+        size_t sectorCount{size / sectorSize};
+        size_t chunkCount{size >= ParallelThreshold ? std::min(pool.Parallelism(), sectorCount) : 1};
+        if (chunkCount <= 1) {
+            (this->*transform)(destination, source, size, sector, sectorSize);
+            return;
+        }
+
+        auto GetChunkStart{[&](size_t chunk) {
+            return (sectorCount * chunk / chunkCount) * sectorSize;
+        }};
+
+        // Any exception thrown while decrypting a chunk is rethrown here after all other chunks are done, so the buffers are never accessed after returning
+        pool.ParallelFor(chunkCount, [&](size_t chunk) {
+            auto start{GetChunkStart(chunk)}, end{GetChunkStart(chunk + 1)};
+            (this->*transform)(destination + start, source + start, end - start, sector + (start / sectorSize), sectorSize);
+        });
     }
 }
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <mbedtls/aes.h>
 #include <mbedtls/cipher.h>
 #include <common.h>
 
@@ -10,12 +11,21 @@ namespace skyline::crypto {
     /**
      * @brief Wrapper for mbedtls for AES decryption using a cipher
      * @note The IV state must be appropriately locked during multi-threaded usage
+     * @note XTS ciphers don't use the IV state for XtsDecrypt, sectors are decrypted statelessly and large buffers are decrypted across the threads of the shared WorkerPool
      */
     class AesCipher {
       private:
+        static constexpr size_t BlockSize{0x10};
+
         mbedtls_cipher_context_t decryptContext;
         std::vector<u8> buffer; //!< A buffer used to avoid constant memory allocation
 
+        bool xts{}; //!< If this is an AES-128-XTS cipher, the members below are only valid if this is true
+        bool hardware{}; //!< If the ARMv8 Cryptography Extensions are used for XTS rather than mbedtls
+        mutable mbedtls_aes_xts_context xtsContext; //!< The decryption context for the fallback XTS implementation, this is only read during decryption despite the non-const API
+        std::array<std::array<u8, BlockSize>, 11> dataKeys; //!< The expanded decryption key for the data in the hardware XTS implementation
+        std::array<std::array<u8, BlockSize>, 11> tweakKeys; //!< The expanded encryption key for the tweak in the hardware XTS implementation
+
         /**
          * @brief Calculates IV for XTS, basically just big to little endian conversion
          */
@@ -26,6 +36,13 @@ namespace skyline::crypto {
             return tweak;
         }
 
+        /**
+         * @brief Decrypts a contiguous range of sectors with XTS, this doesn't touch any mutable state
+         */
+        void XtsDecryptHardware(u8 *destination, const u8 *source, size_t size, size_t sector, size_t sectorSize) const;
+
+        void XtsDecryptSoftware(u8 *destination, const u8 *source, size_t size, size_t sector, size_t sectorSize) const;
+
       public:
         AesCipher(span<u8> key, mbedtls_cipher_type_t type);
 
@@ -51,6 +68,7 @@ namespace skyline::crypto {
 
         /**
          * @brief Decrypts data with XTS, IV will get calculated with the given sector
+         * @note The destination and source buffers can be the same
          */
         void XtsDecrypt(u8 *destination, u8 *source, size_t size, size_t sector, size_t sectorSize);
 
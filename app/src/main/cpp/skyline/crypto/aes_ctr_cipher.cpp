@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "aes_hardware.h"
+#include <common/worker_pool.h>
+#include "aes_ctr_cipher.h"
+
+namespace skyline::crypto {
+    namespace {
+        constexpr size_t ParallelThreshold{0x100000}; //!< The minimum size of data for it to be decrypted across multiple threads
+        constexpr size_t ParallelChunkSize{0x80000}; //!< The minimum amount of data decrypted by each thread
+
+        /**
+         * @return The lower 64 bits of the supplied counter block as a native integer
+         */
+        u64 GetCounterLow(const AesCtrCipher::Block &iv) {
+            u64 value;
+            std::memcpy(&value, iv.data() + 8, sizeof(u64));
+            return util::SwapEndianness(value);
+        }
+    }
+
+    AesCtrCipher::AesCtrCipher(const Block &key) : hardware(hardware::IsSupported()) {
+        mbedtls_aes_init(&context);
+        if (mbedtls_aes_setkey_enc(&context, key.data(), key.size() * 8) != 0)
+            throw exception("Failed to set key for AES-CTR context");
+
+        if (hardware)
+            roundKeys = hardware::ExpandEncryptionKey(key);
+    }
+
+    AesCtrCipher::~AesCtrCipher() {
+        mbedtls_aes_free(&context);
+    }
+
+    void AesCtrCipher::TransformHardware(u8 *destination, const u8 *source, size_t size, const Block &iv, u64 block, size_t offset) const {
+        auto keys{hardware::LoadKeys(roundKeys)};
+
+        auto ivHigh{vld1_u8(iv.data())};
+        auto ivLow{GetCounterLow(iv)};
+        auto GetCounter{[&](u64 index) {
+            return vcombine_u8(ivHigh, vcreate_u8(util::SwapEndianness(ivLow + index)));
+        }};
+
+        // Blocks which aren't entirely covered by the data only use a part of their keystream, they're XORed bytewise
+        auto TransformPartial{[&](size_t length, size_t skip) {
+            Block keystream;
+            vst1q_u8(keystream.data(), hardware::EncryptBlock(GetCounter(block++), keys));
+            for (size_t index{}; index < length; index++)
+                destination[index] = source[index] ^ keystream[skip + index];
+            destination += length;
+            source += length;
+            size -= length;
+        }};
+
+        if (offset)
+            TransformPartial(std::min(size, BlockSize - offset), offset);
+
+        for (; size >= BlockSize * 4; size -= BlockSize * 4, destination += BlockSize * 4, source += BlockSize * 4, block += 4) {
+            std::array<uint8x16_t, 4> states{GetCounter(block), GetCounter(block + 1), GetCounter(block + 2), GetCounter(block + 3)};
+            hardware::EncryptBlocks(states, keys);
+            for (size_t index{}; index < states.size(); index++)
+                vst1q_u8(destination + (index * BlockSize), veorq_u8(vld1q_u8(source + (index * BlockSize)), states[index]));
+        }
+
+        for (; size >= BlockSize; size -= BlockSize, destination += BlockSize, source += BlockSize)
+            vst1q_u8(destination, veorq_u8(vld1q_u8(source), hardware::EncryptBlock(GetCounter(block++), keys)));
+
+        if (size)
+            TransformPartial(size, 0);
+    }
+
+    void AesCtrCipher::TransformSoftware(u8 *destination, const u8 *source, size_t size, const Block &iv, u64 block, size_t offset) const {
+        auto ivLow{GetCounterLow(iv)};
+        Block counter{iv}, keystream;
+        while (size) {
+            u64 counterLow{util::SwapEndianness(ivLow + block++)};
+            std::memcpy(counter.data() + 8, &counterLow, sizeof(u64));
+            mbedtls_aes_crypt_ecb(&context, MBEDTLS_AES_ENCRYPT, counter.data(), keystream.data());
+
+            size_t length{std::min(size, BlockSize - offset)};
+            for (size_t index{}; index < length; index++)
+                destination[index] = source[index] ^ keystream[offset + index];
+            destination += length;
+            source += length;
+            size -= length;
+            offset = 0;
+        }
+    }
+
+    void AesCtrCipher::Transform(u8 *destination, const u8 *source, size_t size, const Block &iv, size_t offset) const {
+        if (hardware)
+            TransformHardware(destination, source, size, iv, offset / BlockSize, offset % BlockSize);
+        else
+            TransformSoftware(destination, source, size, iv, offset / BlockSize, offset % BlockSize);
+    }
+
+    void AesCtrCipher::Decrypt(u8 *destination, const u8 *source, size_t size, const Block &iv, size_t offset) const {
+        auto &pool{WorkerPool::Get()};
+        size_t chunkCount{size >= ParallelThreshold ? std::min(pool.Parallelism(), size / ParallelChunkSize) : 1};
+        if (chunkCount <= 1) {
+            Transform(destination, source, size, iv, offset);
+            return;
+        }
+
+        // Every chunk aside from the first starts on a block boundary in the stream, so only the first and last chunks can contain partial blocks
+        size_t chunkSize{size / chunkCount};
+        auto GetChunkStart{[&](size_t chunk) -> size_t {
+            if (chunk == 0)
+                return 0;
+            if (chunk == chunkCount)
+                return size;
+            return util::AlignDown(offset + (chunk * chunkSize), BlockSize) - offset;
+        }};
+
+        pool.ParallelFor(chunkCount, [&](size_t chunk) {
+            auto start{GetChunkStart(chunk)}, end{GetChunkStart(chunk + 1)};
+            Transform(destination + start, source + start, end - start, iv, offset + start);
+        });
+    }
+}
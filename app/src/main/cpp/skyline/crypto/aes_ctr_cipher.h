@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <mbedtls/aes.h>
+#include <common.h>
+
+namespace skyline::crypto {
+    /**
+     * @brief A stateless AES-128-CTR cipher, the counter is derived from the offset into the stream so any range can be decrypted independently
+     * @note All methods are const and there's no shared mutable state, an instance can be used by any amount of threads concurrently
+     * @note The ARMv8 Cryptography Extensions are used when the CPU supports them, mbedtls is used as a fallback otherwise
+     */
+    class AesCtrCipher {
+      public:
+        static constexpr size_t BlockSize{0x10};
+        static constexpr size_t RoundKeyCount{11}; //!< The amount of round keys for AES-128 including the initial one
+
+        using Block = std::array<u8, BlockSize>;
+
+      private:
+        std::array<Block, RoundKeyCount> roundKeys; //!< The expanded encryption key for the hardware implementation
+        mutable mbedtls_aes_context context; //!< The encryption context for the fallback implementation, this is only read during encryption despite the non-const API
+        bool hardware; //!< If the hardware implementation is used
+
+        /**
+         * @brief XORs the keystream with the source and writes the result into the destination, 'offset' must be within the first block
+         */
+        void TransformHardware(u8 *destination, const u8 *source, size_t size, const Block &iv, u64 block, size_t offset) const;
+
+        void TransformSoftware(u8 *destination, const u8 *source, size_t size, const Block &iv, u64 block, size_t offset) const;
+
+        void Transform(u8 *destination, const u8 *source, size_t size, const Block &iv, size_t offset) const;
+
+      public:
+        AesCtrCipher(const Block &key);
+
+        ~AesCtrCipher();
+
+        AesCtrCipher(const AesCtrCipher &) = delete;
+
+        AesCtrCipher &operator=(const AesCtrCipher &) = delete;
+
+        /**
+         * @brief Decrypts the supplied buffer and writes the result into the destination buffer, large buffers are decrypted across the threads of the shared WorkerPool
+         * @param iv The initial counter block, the block index of the offset is added to the lower 64 bits of it in big-endian
+         * @param offset The offset of the source data into the stream, this doesn't need to be aligned to the block size
+         * @note The destination and source buffers can be the same
+         */
+        void Decrypt(u8 *destination, const u8 *source, size_t size, const Block &iv, size_t offset) const;
+
+        /**
+         * @brief Decrypts the supplied data in-place
+         */
+        void Decrypt(span<u8> data, const Block &iv, size_t offset) const {
+            Decrypt(data.data(), data.data(), data.size(), iv, offset);
+        }
+    };
+}
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <bit>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#include <arm_neon.h>
+#include <common.h>
+
+/**
+ * @brief AES-128 primitives using the ARMv8 Cryptography Extensions
+ * @note This must only be included by translation units compiled with the Cryptography Extensions enabled, none of these functions must be called unless IsSupported returns true
+ */
+namespace skyline::crypto::hardware {
+    constexpr size_t BlockSize{0x10};
+    constexpr size_t RoundKeyCount{11}; //!< The amount of round keys for AES-128 including the initial one
+
+    using Block = std::array<u8, BlockSize>;
+    using RoundKeys = std::array<Block, RoundKeyCount>; //!< An expanded key in memory, this is loaded into registers with LoadKeys prior to use
+    using LoadedRoundKeys = std::array<uint8x16_t, RoundKeyCount>;
+
+    /**
+     * @return The AES-128 encryption key schedule for the supplied key
+     * @note SubWord is performed with AESE, ShiftRows has no effect on it as all columns of the state are identical
+     */
+    inline RoundKeys ExpandEncryptionKey(const Block &key) {
+        constexpr std::array<u8, RoundKeyCount - 1> RoundConstants{0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36};
+
+        std::array<u32, RoundKeyCount * 4> words;
+        std::memcpy(words.data(), key.data(), key.size());
+        for (size_t index{4}; index < words.size(); index++) {
+            u32 word{words[index - 1]};
+            if (index % 4 == 0) {
+                u32 substituted{vgetq_lane_u32(vreinterpretq_u32_u8(vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(word)), vdupq_n_u8(0))), 0)};
+                word = std::rotr(substituted, 8) ^ RoundConstants[(index / 4) - 1]; // Words are little-endian, so RotWord is a right rotation and the round constant is applied to the lowest byte
+            }
+            words[index] = words[index - 4] ^ word;
+        }
+
+        RoundKeys roundKeys;
+        std::memcpy(roundKeys.data(), words.data(), sizeof(roundKeys));
+        return roundKeys;
+    }
+
+    /**
+     * @return The key schedule for the equivalent inverse cipher which is used by AESD, it's derived from the encryption key schedule
+     */
+    inline RoundKeys ExpandDecryptionKey(const RoundKeys &encryptionKeys) {
+        RoundKeys roundKeys;
+        roundKeys.front() = encryptionKeys.back();
+        for (size_t index{1}; index < RoundKeyCount - 1; index++)
+            vst1q_u8(roundKeys[index].data(), vaesimcq_u8(vld1q_u8(encryptionKeys[RoundKeyCount - 1 - index].data())));
+        roundKeys.back() = encryptionKeys.front();
+        return roundKeys;
+    }
+
+    inline LoadedRoundKeys LoadKeys(const RoundKeys &roundKeys) {
+        LoadedRoundKeys keys;
+        for (size_t index{}; index < RoundKeyCount; index++)
+            keys[index] = vld1q_u8(roundKeys[index].data());
+        return keys;
+    }
+
+    inline uint8x16_t EncryptBlock(uint8x16_t state, const LoadedRoundKeys &keys) {
+        for (size_t round{}; round < RoundKeyCount - 2; round++)
+            state = vaesmcq_u8(vaeseq_u8(state, keys[round]));
+        return veorq_u8(vaeseq_u8(state, keys[RoundKeyCount - 2]), keys[RoundKeyCount - 1]);
+    }
+
+    /**
+     * @note The keys must be from ExpandDecryptionKey
+     */
+    inline uint8x16_t DecryptBlock(uint8x16_t state, const LoadedRoundKeys &keys) {
+        for (size_t round{}; round < RoundKeyCount - 2; round++)
+            state = vaesimcq_u8(vaesdq_u8(state, keys[round]));
+        return veorq_u8(vaesdq_u8(state, keys[RoundKeyCount - 2]), keys[RoundKeyCount - 1]);
+    }
+
+    /**
+     * @brief Encrypts or decrypts multiple blocks in an interleaved manner, this hides the multi-cycle latency of the pipelined AES instructions
+     * @param MixColumns AESMC for encryption or AESIMC for decryption
+     * @param Round AESE for encryption or AESD for decryption
+     */
+    template<size_t Count, uint8x16_t MixColumns(uint8x16_t), uint8x16_t Round(uint8x16_t, uint8x16_t)>
+    inline void TransformBlocks(std::array<uint8x16_t, Count> &states, const LoadedRoundKeys &keys) {
+        for (size_t round{}; round < RoundKeyCount - 2; round++)
+            for (auto &state : states)
+                state = MixColumns(Round(state, keys[round]));
+        for (auto &state : states)
+            state = veorq_u8(Round(state, keys[RoundKeyCount - 2]), keys[RoundKeyCount - 1]);
+    }
+
+    template<size_t Count>
+    inline void EncryptBlocks(std::array<uint8x16_t, Count> &states, const LoadedRoundKeys &keys) {
+        TransformBlocks<Count, vaesmcq_u8, vaeseq_u8>(states, keys);
+    }
+
+    template<size_t Count>
+    inline void DecryptBlocks(std::array<uint8x16_t, Count> &states, const LoadedRoundKeys &keys) {
+        TransformBlocks<Count, vaesimcq_u8, vaesdq_u8>(states, keys);
+    }
+
+    /**
+     * @return If the primitives produce the known answer from FIPS-197 Appendix C.1 for both encryption and decryption
+     */
+    inline bool SelfTest() {
+        constexpr Block Key{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+        constexpr Block Plaintext{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+        constexpr Block Ciphertext{0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30, 0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A};
+
+        auto encryptionKeys{ExpandEncryptionKey(Key)};
+        Block result;
+        vst1q_u8(result.data(), EncryptBlock(vld1q_u8(Plaintext.data()), LoadKeys(encryptionKeys)));
+        if (result != Ciphertext)
+            return false;
+
+        vst1q_u8(result.data(), DecryptBlock(vld1q_u8(Ciphertext.data()), LoadKeys(ExpandDecryptionKey(encryptionKeys))));
+        return result == Plaintext;
+    }
+
+    /**
+     * @return If the CPU supports the Cryptography Extensions and they pass SelfTest, this is only evaluated once
+     */
+    inline bool IsSupported() {
+        static const bool supported{(getauxval(AT_HWCAP) & HWCAP_AES) && SelfTest()};
+        return supported;
+    }
+}
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <common/lock_profiler.h>
 #include "gpu/memory_manager.h"
 #include "gpu/command_scheduler.h"
 #include "gpu/presentation_engine.h"
@@ -32,7 +33,7 @@ namespace skyline::gpu {
         vk::raii::PhysicalDevice vkPhysicalDevice;
         u32 vkQueueFamilyIndex{};
         vk::raii::Device vkDevice;
-        std::mutex queueMutex; //!< Synchronizes access to the queue as it is externally synchronized
+        ProfiledMutex queueMutex{LOCK_SITE("GPU::queueMutex")}; //!< Synchronizes access to the queue as it is externally synchronized
         vk::raii::Queue vkQueue; //!< A Vulkan Queue supporting graphics and compute operations
 
         memory::MemoryManager memory;
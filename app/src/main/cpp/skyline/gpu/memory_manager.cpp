@@ -2,6 +2,7 @@
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <gpu.h>
+#include <common/memory_accounting.h>
 #include "memory_manager.h"
 
 namespace skyline::gpu::memory {
@@ -13,6 +14,15 @@ namespace skyline::gpu::memory {
             vk::throwResultException(vk::Result(result), function);
     }
 
+    /**
+     * @return The accounting category for a Vulkan memory block of the supplied memory type
+     */
+    static accounting::Category GetMemoryCategory(VmaAllocator allocator, u32 memoryType) {
+        VkMemoryPropertyFlags flags;
+        vmaGetMemoryTypeProperties(allocator, memoryType, &flags);
+        return (flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) ? accounting::Category::GpuDeviceLocal : accounting::Category::GpuHostVisible;
+    }
+
     StagingBuffer::~StagingBuffer() {
         if (vmaAllocator && vmaAllocation && vkBuffer)
             vmaDestroyBuffer(vmaAllocator, vkBuffer, vmaAllocation);
@@ -60,9 +70,19 @@ namespace skyline::gpu::memory {
             .vkBindImageMemory2KHR = deviceDispatcher->vkBindImageMemory2,
             .vkGetPhysicalDeviceMemoryProperties2KHR = instanceDispatcher->vkGetPhysicalDeviceMemoryProperties2,
         };
+        // VMA allocates memory in large blocks which are suballocated, the blocks are accounted for as they're what determines the host memory usage
+        VmaDeviceMemoryCallbacks deviceMemoryCallbacks{
+            .pfnAllocate = [](VmaAllocator allocator, u32 memoryType, VkDeviceMemory, VkDeviceSize size, void *) {
+                accounting::Allocate(GetMemoryCategory(allocator, memoryType), size);
+            },
+            .pfnFree = [](VmaAllocator allocator, u32 memoryType, VkDeviceMemory, VkDeviceSize size, void *) {
+                accounting::Free(GetMemoryCategory(allocator, memoryType), size);
+            },
+        };
         VmaAllocatorCreateInfo allocatorCreateInfo{
             .physicalDevice = *gpu.vkPhysicalDevice,
             .device = *gpu.vkDevice,
+            .pDeviceMemoryCallbacks = &deviceMemoryCallbacks,
             .instance = *gpu.vkInstance,
             .pVulkanFunctions = &vulkanFunctions,
             .vulkanApiVersion = GPU::VkApiVersion,
@@ -1,6 +1,11 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <linux/memfd.h>
 #include "memory.h"
 #include "types/KProcess.h"
 
@@ -10,6 +15,8 @@ namespace skyline::kernel {
     MemoryManager::~MemoryManager() {
         if (base.address && base.size)
             munmap(reinterpret_cast<void *>(base.address), base.size);
+        if (memoryFd >= 0)
+            close(memoryFd);
     }
 
     constexpr size_t RegionAlignment{1ULL << 21}; //!< The minimum alignment of a HOS memory region
@@ -61,11 +68,20 @@ namespace skyline::kernel {
         if (!base.address)
             throw exception("Cannot find a suitable carveout for the guest address space");
 
-        auto result{mmap(reinterpret_cast<void *>(base.address), base.size, PROT_NONE, MAP_FIXED | MAP_ANONYMOUS | MAP_PRIVATE, -1, 0)};
+        // The guest address space is backed by a shared memory file rather than anonymous memory so that any range in it can be aliased elsewhere without copying
+        // A memfd is used rather than ashmem as it's sparse and not accounted for at creation which allows it to span the entire address space, it also supports punching holes to release memory
+        memoryFd = static_cast<int>(syscall(__NR_memfd_create, "HOS-AS", MFD_CLOEXEC)); // Bionic only exposes memfd_create from API 30
+        if (memoryFd < 0)
+            throw exception("Failed to create the guest address space backing: {}", strerror(errno));
+        if (ftruncate(memoryFd, static_cast<off_t>(base.size)) < 0)
+            throw exception("Failed to resize the guest address space backing to 0x{:X} bytes: {}", base.size, strerror(errno));
+
+        auto result{mmap(reinterpret_cast<void *>(base.address), base.size, PROT_NONE, MAP_FIXED | MAP_SHARED | MAP_NORESERVE, memoryFd, 0)};
         if (result == MAP_FAILED)
             throw exception("Failed to mmap guest address space: {}", strerror(errno));
 
-        chunks = {
+        chunks.clear();
+        for (const auto &chunk : {
             ChunkDescriptor{
                 .ptr = reinterpret_cast<u8 *>(addressSpace.address),
                 .size = base.address - addressSpace.address,
@@ -80,7 +96,8 @@ namespace skyline::kernel {
                 .ptr = reinterpret_cast<u8 *>(base.address + base.size),
                 .size = addressSpace.size - (base.address + base.size),
                 .state = memory::states::Reserved,
-            }};
+            }})
+            chunks.emplace(chunk.ptr, chunk);
     }
 
     void MemoryManager::InitializeRegions(u8 *codeStart, u64 size) {
@@ -138,70 +155,184 @@ namespace skyline::kernel {
     void MemoryManager::InsertChunk(const ChunkDescriptor &chunk) {
         std::unique_lock lock(mutex);
 
-        auto upper{std::upper_bound(chunks.begin(), chunks.end(), chunk.ptr, [](const u8 *ptr, const ChunkDescriptor &chunk) -> bool { return ptr < chunk.ptr; })};
+        auto chunkEnd{chunk.ptr + chunk.size};
+        auto upper{chunks.upper_bound(chunk.ptr)};
         if (upper == chunks.begin())
-            throw exception("InsertChunk: Chunk inserted outside address space: 0x{:X} - 0x{:X} and 0x{:X} - 0x{:X}", upper->ptr, upper->ptr + upper->size, chunk.ptr, chunk.ptr + chunk.size);
+            throw exception("InsertChunk: Chunk inserted outside address space: 0x{:X} - 0x{:X}", chunk.ptr, chunkEnd);
 
-        upper = chunks.erase(upper, std::upper_bound(upper, chunks.end(), chunk.ptr + chunk.size, [](const u8 *ptr, const ChunkDescriptor &chunk) -> bool { return ptr < chunk.ptr + chunk.size; }));
-        if (upper != chunks.end() && upper->ptr < chunk.ptr + chunk.size) {
-            auto end{upper->ptr + upper->size};
-            upper->ptr = chunk.ptr + chunk.size;
-            upper->size = end - upper->ptr;
+        // If the chunk prior to the inserted chunk overlaps with it, we need to truncate it and split off any part of it that extends past the inserted chunk
+        auto &lower{std::prev(upper)->second};
+        auto lowerEnd{lower.ptr + lower.size};
+        if (lower.ptr < chunk.ptr && lowerEnd > chunk.ptr) {
+            if (lowerEnd > chunkEnd) {
+                auto lowerExtension{lower};
+                lowerExtension.ptr = chunkEnd;
+                lowerExtension.size = lowerEnd - chunkEnd;
+                chunks.emplace_hint(upper, lowerExtension.ptr, lowerExtension);
+            }
+            lower.size = chunk.ptr - lower.ptr;
         }
 
-        auto lower{std::prev(upper)};
-        if (lower->ptr == chunk.ptr && lower->size == chunk.size) {
-            lower->state = chunk.state;
-            lower->permission = chunk.permission;
-            lower->attributes = chunk.attributes;
-        } else if (lower->ptr + lower->size > chunk.ptr + chunk.size) {
-            auto lowerExtension{*lower};
-            lowerExtension.ptr = chunk.ptr + chunk.size;
-            lowerExtension.size = (lower->ptr + lower->size) - lowerExtension.ptr;
-
-            lower->size = chunk.ptr - lower->ptr;
-            if (lower->size) {
-                upper = chunks.insert(upper, lowerExtension);
-                chunks.insert(upper, chunk);
-            } else {
-                auto lower2{std::prev(lower)};
-                if (chunk.IsCompatible(*lower2) && lower2->ptr + lower2->size >= chunk.ptr) {
-                    lower2->size = chunk.ptr + chunk.size - lower2->ptr;
-                    upper = chunks.erase(lower);
-                } else {
-                    *lower = chunk;
-                }
-                upper = chunks.insert(upper, lowerExtension);
+        // Any chunks starting inside the inserted chunk are removed, the last one of them may need to be truncated rather than removed if it extends past the inserted chunk
+        auto it{chunks.lower_bound(chunk.ptr)};
+        while (it != chunks.end() && it->first < chunkEnd) {
+            auto existingEnd{it->second.ptr + it->second.size};
+            if (existingEnd > chunkEnd) {
+                auto upperRemainder{it->second};
+                upperRemainder.ptr = chunkEnd;
+                upperRemainder.size = existingEnd - chunkEnd;
+                it = chunks.emplace_hint(chunks.erase(it), upperRemainder.ptr, upperRemainder);
+                break;
             }
-        } else if (chunk.IsCompatible(*lower) && lower->ptr + lower->size >= chunk.ptr) {
-            lower->size = chunk.ptr + chunk.size - lower->ptr;
-        } else {
-            if (lower->ptr + lower->size > chunk.ptr)
-                lower->size = chunk.ptr - lower->ptr;
-            if (upper != chunks.end() && chunk.IsCompatible(*upper) && chunk.ptr + chunk.size >= upper->ptr) {
-                upper->ptr = chunk.ptr;
-                upper->size = chunk.size + upper->size;
-            } else {
-                chunks.insert(upper, chunk);
+            it = chunks.erase(it);
+        }
+
+        auto inserted{chunks.emplace_hint(it, chunk.ptr, chunk)};
+
+        // We need to merge the inserted chunk with any adjacent chunks which are compatible with it
+        if (inserted != chunks.begin()) {
+            auto &previous{std::prev(inserted)->second};
+            if (previous.IsCompatible(chunk) && previous.ptr + previous.size == chunk.ptr) {
+                previous.size += chunk.size;
+                inserted = std::prev(chunks.erase(inserted));
             }
         }
+
+        auto next{std::next(inserted)};
+        if (next != chunks.end() && next->second.IsCompatible(chunk) && inserted->second.ptr + inserted->second.size == next->second.ptr) {
+            inserted->second.size += next->second.size;
+            chunks.erase(next);
+        }
     }
 
     std::optional<ChunkDescriptor> MemoryManager::Get(void *ptr) {
         std::shared_lock lock(mutex);
 
-        auto chunk{std::upper_bound(chunks.begin(), chunks.end(), reinterpret_cast<u8 *>(ptr), [](const u8 *ptr, const ChunkDescriptor &chunk) -> bool { return ptr < chunk.ptr; })};
+        auto chunk{chunks.upper_bound(reinterpret_cast<u8 *>(ptr))};
         if (chunk-- != chunks.begin())
-            if ((chunk->ptr + chunk->size) > ptr)
-                return std::make_optional(*chunk);
+            if ((chunk->second.ptr + chunk->second.size) > ptr)
+                return std::make_optional(chunk->second);
 
         return std::nullopt;
     }
 
+    std::vector<BackingDescriptor> MemoryManager::GetBacking(u8 *ptr, size_t size) {
+        std::vector<BackingDescriptor> backing;
+        auto end{ptr + size};
+
+        auto alias{aliases.upper_bound(ptr)};
+        if (alias != aliases.begin() && std::prev(alias)->second.ptr + std::prev(alias)->second.size > ptr)
+            alias--;
+
+        while (ptr < end) {
+            if (alias != aliases.end() && alias->first <= ptr) {
+                auto aliasEnd{std::min(end, alias->second.ptr + alias->second.size)};
+                backing.push_back(BackingDescriptor{ptr, static_cast<size_t>(aliasEnd - ptr), alias->second.offset + static_cast<u64>(ptr - alias->second.ptr)});
+                ptr = aliasEnd;
+                alias++;
+            } else {
+                auto ownEnd{alias != aliases.end() ? std::min(end, alias->first) : end};
+                backing.push_back(BackingDescriptor{ptr, static_cast<size_t>(ownEnd - ptr), reinterpret_cast<u64>(ptr) - base.address});
+                ptr = ownEnd;
+            }
+        }
+
+        return backing;
+    }
+
+    void MemoryManager::RemoveAliases(u8 *ptr, size_t size) {
+        auto end{ptr + size};
+        auto alias{aliases.lower_bound(ptr)};
+
+        // If the alias prior to the range overlaps with it, it needs to be truncated and any part of it that extends past the range is split off
+        if (alias != aliases.begin()) {
+            auto &lower{std::prev(alias)->second};
+            auto lowerEnd{lower.ptr + lower.size};
+            if (lowerEnd > ptr) {
+                if (lowerEnd > end)
+                    aliases.emplace_hint(alias, end, BackingDescriptor{end, static_cast<size_t>(lowerEnd - end), lower.offset + static_cast<u64>(end - lower.ptr)});
+                lower.size = static_cast<size_t>(ptr - lower.ptr);
+            }
+        }
+
+        while (alias != aliases.end() && alias->first < end) {
+            auto aliasEnd{alias->second.ptr + alias->second.size};
+            if (aliasEnd > end) {
+                BackingDescriptor upperRemainder{end, static_cast<size_t>(aliasEnd - end), alias->second.offset + static_cast<u64>(end - alias->second.ptr)};
+                aliases.emplace_hint(aliases.erase(alias), upperRemainder.ptr, upperRemainder);
+                break;
+            }
+            alias = aliases.erase(alias);
+        }
+    }
+
+    void MemoryManager::MapAlias(u8 *destination, u8 *source, size_t size) {
+        if (!base.IsInside(source) || !base.IsInside(source + size - 1) || !base.IsInside(destination) || !base.IsInside(destination + size - 1))
+            throw exception("Aliased ranges aren't inside guest address space: 0x{:X} - 0x{:X} -> 0x{:X} - 0x{:X}", source, source + size, destination, destination + size);
+        if (!util::PageAligned(source) || !util::PageAligned(destination) || !util::PageAligned(size))
+            throw exception("Aliased ranges aren't page-aligned: 0x{:X} - 0x{:X} -> 0x{:X} - 0x{:X}", source, source + size, destination, destination + size);
+
+        std::unique_lock lock(mutex);
+
+        // The source may itself alias other memory, the destination needs to share the memory that actually backs it rather than the source's own memory
+        auto backing{GetBacking(source, size)};
+        RemoveAliases(destination, size);
+        for (const auto &range : backing) {
+            auto rangeDestination{destination + (range.ptr - source)}, rangeEnd{rangeDestination + range.size};
+
+            // Every part of the destination is mapped with the permission of the chunk covering it, the caller sets these up prior to aliasing
+            auto chunk{std::prev(chunks.upper_bound(rangeDestination))}; // Chunks cover the entire address space so there's always one containing the destination
+            for (auto ptr{rangeDestination}; ptr < rangeEnd; chunk++) {
+                auto end{std::min(rangeEnd, chunk->second.ptr + chunk->second.size)};
+                if (mmap(ptr, static_cast<size_t>(end - ptr), chunk->second.permission.Get(), MAP_FIXED | MAP_SHARED, memoryFd, static_cast<off_t>(range.offset + static_cast<u64>(ptr - rangeDestination))) == MAP_FAILED)
+                    throw exception("Failed to alias 0x{:X} - 0x{:X} at 0x{:X}: {}", range.ptr, range.ptr + range.size, ptr, strerror(errno));
+                ptr = end;
+            }
+
+            if (range.offset != reinterpret_cast<u64>(rangeDestination) - base.address)
+                aliases.emplace(rangeDestination, BackingDescriptor{rangeDestination, range.size, range.offset});
+        }
+    }
+
+    void MemoryManager::RestoreBacking(u8 *ptr, size_t size) {
+        if (!base.IsInside(ptr) || !base.IsInside(ptr + size - 1))
+            throw exception("Restored range isn't inside guest address space: 0x{:X} - 0x{:X}", ptr, ptr + size);
+        if (!util::PageAligned(ptr) || !util::PageAligned(size))
+            throw exception("Restored range isn't page-aligned: 0x{:X} - 0x{:X}", ptr, ptr + size);
+
+        std::unique_lock lock(mutex);
+        RemoveAliases(ptr, size);
+        if (mmap(ptr, size, PROT_NONE, MAP_FIXED | MAP_SHARED, memoryFd, reinterpret_cast<u64>(ptr) - base.address) == MAP_FAILED)
+            throw exception("Failed to restore the backing of 0x{:X} - 0x{:X}: {}", ptr, ptr + size, strerror(errno));
+    }
+
+    void MemoryManager::FreeMemory(u8 *ptr, size_t size) {
+        if (!size)
+            return;
+
+        // The backing is a memfd so pages need to be removed from it, MADV_DONTNEED would only drop them from the page tables
+        // We punch holes in the file directly rather than using MADV_REMOVE as the latter fails on ranges which aren't mapped as writable on the host
+        std::shared_lock lock(mutex);
+        for (const auto &range : GetBacking(ptr, size)) {
+            if (range.offset != reinterpret_cast<u64>(range.ptr) - base.address)
+                continue; // Aliased ranges share the memory of another range which must not be released
+
+            if (fallocate(memoryFd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(range.offset), static_cast<off_t>(range.size)) < 0)
+                state.logger->Warn("Failed to free 0x{:X} - 0x{:X}: {}", range.ptr, range.ptr + range.size, strerror(errno));
+        }
+    }
+
+    size_t MemoryManager::GetResidentMemoryUsage() {
+        struct stat backingStat{};
+        if (fstat(memoryFd, &backingStat) < 0)
+            throw exception("Failed to query the guest address space backing: {}", strerror(errno));
+        return static_cast<size_t>(backingStat.st_blocks) * 512; // 'st_blocks' is always in 512-byte units regardless of the block size of the filesystem
+    }
+
     size_t MemoryManager::GetUserMemoryUsage() {
         std::shared_lock lock(mutex);
         size_t size{};
-        for (const auto &chunk : chunks)
+        for (const auto &[address, chunk] : chunks)
             if (chunk.state == memory::states::Heap)
                 size += chunk.size;
         return size + code.size + state.process->mainThreadStack->size;
@@ -208,13 +208,35 @@ namespace skyline {
             }
         };
 
+        /**
+         * @brief A range of guest memory and the offset of the memory backing it in the shared memory file
+         */
+        struct BackingDescriptor {
+            u8 *ptr;
+            size_t size;
+            u64 offset; //!< The offset of the memory backing 'ptr' in 'MemoryManager::memoryFd'
+        };
+
         /**
          * @brief MemoryManager keeps track of guest virtual memory and its related attributes
          */
         class MemoryManager {
           private:
             const DeviceState &state;
-            std::vector<ChunkDescriptor> chunks;
+            std::map<u8 *, ChunkDescriptor> chunks; //!< All chunks in the address space keyed by their base address, they're contiguous and cover the entire address space
+            std::map<u8 *, BackingDescriptor> aliases; //!< All ranges which are backed by memory other than their own due to MapAlias keyed by their base address, they don't overlap
+
+            /**
+             * @return The ranges of the shared memory file which back the supplied range, this resolves any aliases within it
+             * @note 'mutex' **must** be locked by the calling thread prior to calling this
+             */
+            std::vector<BackingDescriptor> GetBacking(u8 *ptr, size_t size);
+
+            /**
+             * @brief Removes any aliases inside the supplied range, aliases which partially overlap it are truncated
+             * @note 'mutex' **must** be locked exclusively by the calling thread prior to calling this
+             */
+            void RemoveAliases(u8 *ptr, size_t size);
 
           public:
             memory::Region addressSpace{}; //!< The entire address space
@@ -225,6 +247,8 @@ namespace skyline {
             memory::Region stack{};
             memory::Region tlsIo{}; //!< TLS/IO
 
+            int memoryFd{-1}; //!< A shared memory file which backs all of 'base', a guest address is backed by the file at an offset of its distance from the start of 'base'
+
             std::shared_mutex mutex; //!< Synchronizes any operations done on the VMM, it's locked in shared mode by readers and exclusive mode by writers
 
             MemoryManager(const DeviceState &state);
@@ -238,10 +262,42 @@ namespace skyline {
 
             void InitializeRegions(u8 *codeStart, u64 size);
 
+            /**
+             * @brief Inserts a chunk into the address space, any overlapping chunks are split or replaced and adjacent compatible chunks are merged
+             * @note This is O(log n + k) where k is the amount of chunks which are completely covered by the inserted chunk
+             */
             void InsertChunk(const ChunkDescriptor &chunk);
 
+            /**
+             * @return The chunk that contains the supplied address, if there is one
+             * @note This is O(log n) and only locks 'mutex' in shared mode
+             */
             std::optional<ChunkDescriptor> Get(void *ptr);
 
+            /**
+             * @brief Maps the backing memory of the source range at the destination range, both ranges will refer to the same memory after this
+             * @note This doesn't modify any chunks, the caller is responsible for updating the state of both ranges
+             * @note The destination is mapped on the host with the permissions of the chunks covering it, they should be inserted prior to calling this
+             */
+            void MapAlias(u8 *destination, u8 *source, size_t size);
+
+            /**
+             * @brief Restores the backing of a range to its own memory with no host permissions, this undoes a MapAlias or any other mapping over the range
+             */
+            void RestoreBacking(u8 *ptr, size_t size);
+
+            /**
+             * @brief Releases the host memory backing a range, it'll be committed again as zero-filled pages when it's next accessed
+             * @note This works regardless of the host protection of the range, any parts of it which alias another range are skipped
+             */
+            void FreeMemory(u8 *ptr, size_t size);
+
+            /**
+             * @return The size of all guest memory that is committed in host memory in bytes, this is lower than GetUserMemoryUsage as memory is only committed when it's first accessed and is released by FreeMemory
+             * @note This is a single query of the size of the backing rather than a walk over the address space, aliased memory is only counted once
+             */
+            size_t GetResidentMemoryUsage();
+
             /**
              * @return The cumulative size of all heap (Physical Memory + Process Heap) memory mappings, the code region and the main thread stack in bytes
              */
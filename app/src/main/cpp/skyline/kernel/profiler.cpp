@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <unistd.h>
+#include <common/settings.h>
+#include <common/signal.h>
+#include <loader/loader.h>
+#include <os.h>
+#include "profiler.h"
+
+namespace skyline::kernel {
+    namespace {
+        constexpr std::chrono::milliseconds DrainInterval{100}; //!< The interval at which all sample buffers are drained, a buffer must not fill up within this interval at the maximum frequency
+
+        /**
+         * @brief A minimal writer for Protocol Buffers messages, this only supports varint and length-delimited fields as that's all a pprof profile requires
+         * @url https://developers.google.com/protocol-buffers/docs/encoding
+         */
+        struct ProtobufWriter {
+            std::string buffer;
+
+            void Varint(u64 value) {
+                while (value >= 0x80) {
+                    buffer.push_back(static_cast<char>(value | 0x80));
+                    value >>= 7;
+                }
+                buffer.push_back(static_cast<char>(value));
+            }
+
+            void UInt(u32 field, u64 value) {
+                Varint(field << 3);
+                Varint(value);
+            }
+
+            void Bytes(u32 field, std::string_view value) {
+                Varint((field << 3) | 2);
+                Varint(value.size());
+                buffer.append(value);
+            }
+
+            void Message(u32 field, const ProtobufWriter &message) {
+                Bytes(field, message.buffer);
+            }
+        };
+    }
+
+    Profiler::Profiler(const DeviceState &state) : state(state), frequency(state.settings->profilerFrequency), period(frequency ? constant::NsInSecond / frequency : 0) {
+        if (Enabled())
+            drainThread = std::thread(&Profiler::DrainThread, this);
+    }
+
+    Profiler::~Profiler() {
+        if (!Enabled())
+            return;
+
+        {
+            std::lock_guard guard(mutex);
+            drainExit = true;
+        }
+        drainCondition.notify_all();
+        drainThread.join();
+    }
+
+    void Profiler::DrainBuffer(SampleBuffer &buffer) {
+        auto tail{buffer.tail.load(std::memory_order_relaxed)}, head{buffer.head.load(std::memory_order_acquire)};
+        for (; tail != head; tail++) {
+            auto &sample{buffer.samples[tail % SampleBufferSize]};
+            stacks[std::vector<void *>(sample.frames.begin(), sample.frames.begin() + sample.depth)]++;
+        }
+        buffer.tail.store(tail, std::memory_order_release);
+
+        droppedSamples += buffer.dropped.exchange(0, std::memory_order_relaxed);
+        hostSamples += buffer.host.exchange(0, std::memory_order_relaxed);
+    }
+
+    void Profiler::DrainThread() {
+        pthread_setname_np(pthread_self(), "Sky-Profiler");
+
+        std::unique_lock lock(mutex);
+        while (!drainExit) {
+            drainCondition.wait_for(lock, DrainInterval);
+            for (auto &buffer : buffers)
+                DrainBuffer(buffer);
+        }
+    }
+
+    void Profiler::StartThread(void *stackTop) {
+        if (!Enabled())
+            return;
+
+        SampleBuffer *buffer;
+        {
+            std::lock_guard guard(mutex);
+            if (freeBuffers.empty()) {
+                buffer = &buffers.emplace_back();
+            } else {
+                buffer = freeBuffers.back();
+                freeBuffers.pop_back();
+            }
+        }
+        buffer->stackTop = stackTop;
+        threadBuffer = buffer;
+
+        // The timer measures the CPU time of the thread so that samples are proportional to the time spent running rather than waiting
+        struct sigevent event{
+            .sigev_signo = ProfilerSignal,
+            .sigev_notify = SIGEV_THREAD_ID,
+            .sigev_notify_thread_id = gettid(),
+        };
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &threadTimer))
+            throw exception("timer_create has failed with '{}'", strerror(errno));
+
+        timespec interval{
+            .tv_sec = static_cast<time_t>(period.count() / constant::NsInSecond),
+            .tv_nsec = static_cast<long>(period.count() % constant::NsInSecond),
+        };
+        struct itimerspec spec{.it_interval = interval, .it_value = interval};
+        timer_settime(threadTimer, 0, &spec, nullptr);
+    }
+
+    void Profiler::StopThread() {
+        if (!threadBuffer)
+            return;
+
+        timer_delete(threadTimer);
+        threadTimer = {};
+
+        // The buffer must be detached from this thread before it's released as a pending signal could still write to it otherwise
+        auto buffer{std::exchange(threadBuffer, nullptr)};
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+
+        std::lock_guard guard(mutex);
+        freeBuffers.push_back(buffer);
+    }
+
+    void Profiler::SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls) {
+        auto buffer{threadBuffer};
+        if (!buffer)
+            return;
+
+        if (!*tls) {
+            // Host code can be profiled with host tools, we only count it to determine the share of time spent in guest code
+            buffer->host.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto head{buffer->head.load(std::memory_order_relaxed)};
+        if (head - buffer->tail.load(std::memory_order_acquire) >= SampleBufferSize) {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto &sample{buffer->samples[head % SampleBufferSize]};
+        sample.frames[0] = reinterpret_cast<void *>(ctx->uc_mcontext.pc);
+
+        // Frames are only followed while they're on the guest stack and strictly ascending, this prevents faults and loops on corrupted or omitted frame pointers
+        u32 depth{1};
+        auto frame{reinterpret_cast<signal::StackFrame *>(ctx->uc_mcontext.regs[29])};
+        auto stackBottom{reinterpret_cast<signal::StackFrame *>(ctx->uc_mcontext.sp)}, stackTop{reinterpret_cast<signal::StackFrame *>(buffer->stackTop)};
+        while (depth < MaxStackDepth && frame >= stackBottom && frame + 1 <= stackTop && util::IsAligned(frame, sizeof(u64)) && frame->lr) {
+            sample.frames[depth++] = frame->lr;
+            if (frame->next <= frame)
+                break;
+            frame = frame->next;
+        }
+        sample.depth = depth;
+
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    void Profiler::Dump(const std::string &path) {
+        std::lock_guard guard(mutex);
+        for (auto &buffer : buffers)
+            DrainBuffer(buffer);
+
+        if (stacks.empty())
+            return;
+
+        // Every unique address is a location, they're symbolized in a single batch
+        std::vector<void *> addresses;
+        std::unordered_map<void *, u64> locationIds;
+        for (const auto &[stack, count] : stacks)
+            for (auto frame : stack)
+                if (locationIds.try_emplace(frame, addresses.size() + 1).second)
+                    addresses.push_back(frame);
+        auto symbols{state.loader->ResolveSymbols(addresses)};
+
+        std::vector<std::string> strings{""}; // The first entry of the string table must be an empty string
+        std::unordered_map<std::string, u64> stringIds;
+        auto GetStringId{[&](std::string string) {
+            auto [it, inserted]{stringIds.try_emplace(string, strings.size())};
+            if (inserted)
+                strings.emplace_back(std::move(string));
+            return it->second;
+        }};
+
+        ProtobufWriter profile;
+        auto WriteValueType{[&](u32 field, std::string_view type, std::string_view unit) {
+            ProtobufWriter valueType;
+            valueType.UInt(1, GetStringId(std::string(type)));
+            valueType.UInt(2, GetStringId(std::string(unit)));
+            profile.Message(field, valueType);
+        }};
+        WriteValueType(1, "samples", "count"); // Profile::sample_type
+        WriteValueType(1, "cpu", "nanoseconds");
+        WriteValueType(11, "cpu", "nanoseconds"); // Profile::period_type
+        profile.UInt(12, static_cast<u64>(period.count())); // Profile::period
+
+        size_t sampleCount{};
+        for (const auto &[stack, count] : stacks) {
+            ProtobufWriter sample;
+            for (auto frame : stack)
+                sample.UInt(1, locationIds[frame]); // Sample::location_id
+            sample.UInt(2, count); // Sample::value
+            sample.UInt(2, count * static_cast<u64>(period.count()));
+            profile.Message(2, sample); // Profile::sample
+            sampleCount += count;
+        }
+
+        // Every location has a function of its own as guest code has no line information, functions with the same name are deduplicated
+        std::unordered_map<u64, u64> functionIds; // A map from the string ID of a function's name to its ID
+        for (size_t index{}; index < addresses.size(); index++) {
+            const auto &symbol{symbols[index]};
+            std::string name{symbol.name ? std::string(state.loader->Demangle(symbol.name)) : fmt::format("0x{:X}", reinterpret_cast<uintptr_t>(addresses[index]))};
+            auto nameId{GetStringId(name)};
+
+            auto [function, inserted]{functionIds.try_emplace(nameId, functionIds.size() + 1)};
+            if (inserted) {
+                ProtobufWriter functionMessage;
+                functionMessage.UInt(1, function->second); // Function::id
+                functionMessage.UInt(2, nameId); // Function::name
+                functionMessage.UInt(3, nameId); // Function::system_name
+                functionMessage.UInt(4, GetStringId(std::string(symbol.executableName))); // Function::filename
+                profile.Message(5, functionMessage); // Profile::function
+            }
+
+            ProtobufWriter line, location;
+            line.UInt(1, function->second); // Line::function_id
+            location.UInt(1, index + 1); // Location::id
+            location.UInt(3, reinterpret_cast<u64>(addresses[index])); // Location::address
+            location.Message(4, line); // Location::line
+            profile.Message(4, location); // Profile::location
+        }
+
+        for (const auto &string : strings)
+            profile.Bytes(6, string); // Profile::string_table
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.write(profile.buffer.data(), static_cast<std::streamsize>(profile.buffer.size())))
+            throw exception("Failed to write profile to '{}'", path);
+
+        state.logger->Info("Wrote guest profile with {} samples ({} dropped, {} in host code) to '{}'", sampleCount, droppedSamples, hostSamples, path);
+    }
+}
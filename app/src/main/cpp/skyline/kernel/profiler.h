@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <csignal>
+#include <condition_variable>
+#include <common.h>
+
+namespace skyline::kernel {
+    /**
+     * @brief A sampling profiler for guest code, guest threads are periodically interrupted by a signal which records their PC and a frame-pointer stack walk
+     * @note Samples are recorded into a lock-free buffer per thread which is drained by a background thread, they're symbolized when the profile is dumped
+     */
+    class Profiler {
+      public:
+        inline static int ProfilerSignal{SIGRTMIN + 2}; //!< The signal used to interrupt running threads to sample them
+        static constexpr size_t MaxStackDepth{32}; //!< The maximum amount of frames that are recorded for a sample, including the PC
+        static constexpr size_t SampleBufferSize{0x400}; //!< The amount of samples that a thread can record before they're drained, any further samples are dropped
+
+        /**
+         * @brief A single sample of the guest call stack
+         */
+        struct Sample {
+            u32 depth; //!< The amount of valid entries in frames
+            std::array<void *, MaxStackDepth> frames; //!< The PC followed by the return addresses from walking the frame pointer chain
+        };
+
+        /**
+         * @brief A single-producer single-consumer ring buffer of samples, the producer is the signal handler on a thread and the consumer is the drain thread
+         * @note Buffers are reused by subsequent threads once a thread exits, the indices are never reset so any pending samples are still drained
+         */
+        struct SampleBuffer {
+            std::array<Sample, SampleBufferSize> samples;
+            std::atomic<size_t> head{}; //!< The index of the next sample to be written, this is only modified by the producer
+            std::atomic<size_t> tail{}; //!< The index of the next sample to be read, this is only modified by the consumer
+            std::atomic<size_t> dropped{}; //!< The amount of samples that were dropped due to the buffer being full
+            std::atomic<size_t> host{}; //!< The amount of samples that were taken while the thread was running host code, these aren't recorded
+            void *stackTop{}; //!< The top of the guest stack of the thread using this buffer, frames outside the stack aren't walked
+        };
+
+      private:
+        const DeviceState &state;
+        std::mutex mutex; //!< Synchronizes access to all buffers and aggregated samples
+        std::list<SampleBuffer> buffers; //!< All sample buffers, they're never freed until the profiler is destroyed
+        std::vector<SampleBuffer *> freeBuffers; //!< Buffers which aren't in use by any thread
+        std::map<std::vector<void *>, u64> stacks; //!< The amount of samples for every unique call stack that's been drained
+        size_t droppedSamples{}, hostSamples{}; //!< The amount of samples that were dropped or taken in host code over all drained buffers
+
+        std::thread drainThread; //!< A thread which periodically drains all sample buffers into the aggregated samples
+        std::condition_variable drainCondition; //!< Signalled to wake up the drain thread when the profiler is destroyed
+        bool drainExit{}; //!< If the drain thread should exit
+
+        static thread_local inline SampleBuffer *threadBuffer{}; //!< The sample buffer of the guest thread running on the current host thread
+        static thread_local inline timer_t threadTimer{}; //!< The sampling timer of the guest thread running on the current host thread
+
+        /**
+         * @brief Moves all pending samples from a buffer into the aggregated samples
+         * @note 'mutex' must be locked by the caller
+         */
+        void DrainBuffer(SampleBuffer &buffer);
+
+        void DrainThread();
+
+      public:
+        u32 frequency; //!< The sampling frequency in Hz per thread, the profiler is disabled if this is 0
+        std::chrono::nanoseconds period; //!< The interval of CPU time between samples of a thread
+
+        Profiler(const DeviceState &state);
+
+        ~Profiler();
+
+        bool Enabled() {
+            return frequency != 0;
+        }
+
+        /**
+         * @brief Starts sampling the calling thread, this should be called prior to entering guest code on a guest thread
+         * @param stackTop The top of the guest stack of the thread, this is used to bound frame-pointer walks
+         */
+        void StartThread(void *stackTop);
+
+        /**
+         * @brief Stops sampling the calling thread, this must be called on the same host thread as StartThread
+         */
+        void StopThread();
+
+        /**
+         * @brief Records a sample of guest code on the current thread, host code is only counted
+         */
+        static void SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls);
+
+        /**
+         * @brief Symbolizes all samples taken so far and writes them to a file in the pprof format
+         * @note The profile is uncompressed, pprof accepts both compressed and uncompressed profiles
+         * @note This is safe to call while the profiler is running, any samples taken after it will not be in the written profile
+         */
+        void Dump(const std::string &path);
+    };
+}
@@ -8,7 +8,7 @@
 #include "scheduler.h"
 
 namespace skyline::kernel {
-    Scheduler::CoreContext::CoreContext(u8 id, u8 preemptionPriority) : id(id), preemptionPriority(preemptionPriority) {}
+    Scheduler::CoreContext::CoreContext(u8 id, u8 preemptionPriority) : id(id), preemptionPriority(preemptionPriority), track(trace::CreateTrack(trace::TrackIds::SchedulerCore, util::Format("Core {}", id), id)) {}
 
     Scheduler::Scheduler(const DeviceState &state) : state(state) {}
 
@@ -27,7 +27,20 @@ namespace skyline::kernel {
         }
     }
 
-    Scheduler::CoreContext &Scheduler::GetOptimalCoreForThread(const std::shared_ptr<type::KThread> &thread) {
+    void Scheduler::BeginOccupancy(CoreContext &core, type::KThread *thread) {
+        TRACE_EVENT_BEGIN("scheduler", "Occupied", core.track, "ThreadId", thread->id, "Priority", static_cast<u32>(thread->priority.load()));
+        OccupiedCore = core.id;
+    }
+
+    void Scheduler::EndOccupancy() {
+        if (OccupiedCore == constant::ParkedCoreId)
+            return;
+
+        TRACE_EVENT_END("scheduler", cores.at(OccupiedCore).track);
+        OccupiedCore = constant::ParkedCoreId;
+    }
+
+    Scheduler::CoreContext &Scheduler::GetOptimalCoreForThread(type::KThread *thread) {
         auto *currentCore{&cores.at(thread->coreId)};
 
         if (!currentCore->queue.empty() && thread->affinityMask.count() != 1) {
@@ -82,7 +95,7 @@ namespace skyline::kernel {
         return *currentCore;
     }
 
-    void Scheduler::InsertThread(const std::shared_ptr<type::KThread> &thread) {
+    void Scheduler::InsertThread(type::KThread *thread) {
         auto &core{cores.at(thread->coreId)};
         std::unique_lock lock(core.mutex);
         auto nextThread{std::upper_bound(core.queue.begin(), core.queue.end(), thread->priority.load(), type::KThread::IsHigherPriority)};
@@ -96,7 +109,7 @@ namespace skyline::kernel {
                 core.queue.splice(std::upper_bound(core.queue.begin(), core.queue.end(), front->priority.load(), type::KThread::IsHigherPriority), core.queue, core.queue.begin());
                 core.queue.push_front(thread);
 
-                if (state.thread != front) {
+                if (state.thread.get() != front) {
                     // If the calling thread isn't at the front, we need to send it an OS signal to yield
                     if (!front->pendingYield) {
                         // We only want to yield the thread if it hasn't already been sent a signal to yield in the past
@@ -112,14 +125,14 @@ namespace skyline::kernel {
             } else {
                 core.queue.push_front(thread);
             }
-            if (thread != state.thread)
+            if (thread != state.thread.get())
                 thread->scheduleCondition.notify_one(); // We only want to trigger the conditional variable if the current thread isn't inserting itself
         } else {
             core.queue.insert(nextThread, thread);
         }
     }
 
-    void Scheduler::MigrateToCore(const std::shared_ptr<type::KThread> &thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<std::mutex> &lock) {
+    void Scheduler::MigrateToCore(type::KThread *thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<ProfiledMutex> &lock) {
         // We need to check if the thread was in its resident core's queue
         // If it was, we need to remove it from the queue
         auto it{std::find(currentCore->queue.begin(), currentCore->queue.end(), thread)};
@@ -141,7 +154,7 @@ namespace skyline::kernel {
     }
 
     void Scheduler::WaitSchedule(bool loadBalance) {
-        auto &thread{state.thread};
+        auto thread{state.thread.get()};
         CoreContext *core{&cores.at(thread->coreId)};
         std::unique_lock lock(core->mutex);
 
@@ -162,7 +175,7 @@ namespace skyline::kernel {
             while (!thread->scheduleCondition.wait_for(lock, loadBalanceThreshold, wakeFunction)) {
                 lock.unlock(); // We cannot call GetOptimalCoreForThread without relinquishing the core mutex
                 std::lock_guard migrationLock(thread->coreMigrationMutex);
-                auto newCore{&GetOptimalCoreForThread(state.thread)};
+                auto newCore{&GetOptimalCoreForThread(thread)};
                 lock.lock();
                 if (core != newCore)
                     MigrateToCore(thread, core, newCore, lock);
@@ -178,10 +191,11 @@ namespace skyline::kernel {
             thread->ArmPreemptionTimer(PreemptiveTimeslice);
 
         thread->timesliceStart = util::GetTimeTicks();
+        BeginOccupancy(*core, thread);
     }
 
     bool Scheduler::TimedWaitSchedule(std::chrono::nanoseconds timeout) {
-        auto &thread{state.thread};
+        auto thread{state.thread.get()};
         auto *core{&cores.at(thread->coreId)};
 
         TRACE_EVENT("scheduler", "TimedWaitSchedule");
@@ -197,6 +211,7 @@ namespace skyline::kernel {
                 thread->ArmPreemptionTimer(PreemptiveTimeslice);
 
             thread->timesliceStart = util::GetTimeTicks();
+            BeginOccupancy(*core, thread);
 
             return true;
         } else {
@@ -205,7 +220,7 @@ namespace skyline::kernel {
     }
 
     void Scheduler::Rotate(bool cooperative) {
-        auto &thread{state.thread};
+        auto thread{state.thread.get()};
         auto &core{cores.at(thread->coreId)};
 
         std::unique_lock lock(core.mutex);
@@ -223,6 +238,8 @@ namespace skyline::kernel {
             throw exception("T{} called Rotate while not being in C{}'s queue", thread->id, thread->coreId);
         }
 
+        EndOccupancy();
+
         thread->averageTimeslice = (thread->averageTimeslice / 4) + (3 * (util::GetTimeTicks() - thread->timesliceStart / 4));
 
         thread->DisarmPreemptionTimer(); // If a preemptive thread did a cooperative yield then we need to disarm the preemptive timer
@@ -231,7 +248,7 @@ namespace skyline::kernel {
     }
 
     void Scheduler::RemoveThread() {
-        auto &thread{state.thread};
+        auto thread{state.thread.get()};
         auto &core{cores.at(thread->coreId)};
         {
             std::unique_lock lock(core.mutex);
@@ -249,13 +266,15 @@ namespace skyline::kernel {
             }
         }
 
+        EndOccupancy();
+
         thread->DisarmPreemptionTimer();
         thread->pendingYield = false;
         thread->forceYield = false;
         YieldPending = false;
     }
 
-    void Scheduler::UpdatePriority(const std::shared_ptr<type::KThread> &thread) {
+    void Scheduler::UpdatePriority(type::KThread *thread) {
         std::lock_guard migrationLock(thread->coreMigrationMutex);
         auto *core{&cores.at(thread->coreId)};
         std::unique_lock coreLock(core->mutex);
@@ -295,7 +314,7 @@ namespace skyline::kernel {
         }
     }
 
-    void Scheduler::UpdateCore(const std::shared_ptr<type::KThread> &thread) {
+    void Scheduler::UpdateCore(type::KThread *thread) {
         auto *core{&cores.at(thread->coreId)};
         std::lock_guard coreLock(core->mutex);
         if (core->queue.front() == thread)
@@ -305,7 +324,7 @@ namespace skyline::kernel {
     }
 
     void Scheduler::ParkThread() {
-        auto &thread{state.thread};
+        auto thread{state.thread.get()};
         std::lock_guard migrationLock(thread->coreMigrationMutex);
         RemoveThread();
 
@@ -327,10 +346,10 @@ namespace skyline::kernel {
     void Scheduler::WakeParkedThread() {
         std::unique_lock parkedLock(parkedMutex);
         if (!parkedQueue.empty()) {
-            auto &thread{state.thread};
+            auto thread{state.thread.get()};
             auto &core{cores.at(thread->coreId)};
             std::unique_lock coreLock(core.mutex);
-            auto nextThread{core.queue.size() > 1 ? *std::next(core.queue.begin()) : nullptr};
+            type::KThread *nextThread{core.queue.size() > 1 ? *std::next(core.queue.begin()) : nullptr};
             nextThread = nextThread->priority == thread->priority ? nextThread : nullptr; // If the next thread doesn't have the same priority then it won't be scheduled next
             auto parkedThread{parkedQueue.front()};
 
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <common.h>
+#include <common/trace.h>
+#include <common/lock_profiler.h>
 #include <condition_variable>
 
 namespace skyline {
@@ -46,8 +48,9 @@ namespace skyline {
             struct CoreContext {
                 u8 id;
                 u8 preemptionPriority; //!< The priority at which this core becomes preemptive as opposed to cooperative
-                std::mutex mutex; //!< Synchronizes all operations on the queue
-                std::list<std::shared_ptr<type::KThread>> queue; //!< A queue of threads which are running or to be run on this core
+                ProfiledMutex mutex{LOCK_SITE("Scheduler::CoreContext::mutex")}; //!< Synchronizes all operations on the queue
+                std::list<type::KThread *> queue; //!< A queue of threads which are running or to be run on this core, these are borrowed as threads are owned by their process for their entire lifetime
+                perfetto::Track track; //!< Perfetto track with a slice for every thread that's run on this core
 
                 CoreContext(u8 id, u8 preemptionPriority);
             };
@@ -55,14 +58,26 @@ namespace skyline {
             std::array<CoreContext, constant::CoreCount> cores{CoreContext(0, 59), CoreContext(1, 59), CoreContext(2, 59), CoreContext(3, 63)};
 
             std::mutex parkedMutex; //!< Synchronizes all operations on the queue of parked threads
-            std::list<std::shared_ptr<type::KThread>> parkedQueue; //!< A queue of threads which are parked and waiting on core migration
+            std::list<type::KThread *> parkedQueue; //!< A queue of threads which are parked and waiting on core migration
+
+            inline static thread_local u8 OccupiedCore{constant::ParkedCoreId}; //!< The core with an open occupancy slice for the thread on this host thread, if any
+
+            /**
+             * @brief Opens a slice on the track of the supplied core for the calling thread being scheduled on it
+             */
+            void BeginOccupancy(CoreContext &core, type::KThread *thread);
+
+            /**
+             * @brief Closes the occupancy slice of the calling thread, if it has one open
+             */
+            void EndOccupancy();
 
             /**
              * @brief Migrate a thread from its resident core to its ideal core
              * @note 'KThread::coreMigrationMutex' **must** be locked by the calling thread prior to calling this
              * @note This is used to handle non-cooperative core affinity mask changes where the resident core is not in its new affinity mask
              */
-            void MigrateToCore(const std::shared_ptr<type::KThread> &thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<std::mutex> &lock);
+            void MigrateToCore(type::KThread *thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<ProfiledMutex> &lock);
 
           public:
             static constexpr std::chrono::milliseconds PreemptiveTimeslice{10}; //!< The duration of time a preemptive thread can run before yielding
@@ -83,12 +98,12 @@ namespace skyline {
              * @note No core mutexes should be held by the calling thread, that will cause a recursive lock and lead to a deadlock
              * @return A reference to the CoreContext of the optimal core
              */
-            CoreContext &GetOptimalCoreForThread(const std::shared_ptr<type::KThread> &thread);
+            CoreContext &GetOptimalCoreForThread(type::KThread *thread);
 
             /**
              * @brief Inserts the specified thread into the scheduler queue at the appropriate location based on its priority
              */
-            void InsertThread(const std::shared_ptr<type::KThread> &thread);
+            void InsertThread(type::KThread *thread);
 
             /**
              * @brief Wait for the calling thread to be scheduled on its resident core
@@ -118,13 +133,13 @@ namespace skyline {
             /**
              * @brief Updates the placement of the supplied thread in its resident core's queue according to its current priority
              */
-            void UpdatePriority(const std::shared_ptr<type::KThread> &thread);
+            void UpdatePriority(type::KThread *thread);
 
             /**
              * @brief Updates the core that the supplied thread is resident to according to its new affinity mask and ideal core
              * @note This supports changing the core of a thread which is currently running
              */
-            void UpdateCore(const std::shared_ptr<type::KThread> &thread);
+            void UpdateCore(type::KThread *thread);
 
             /**
              * @brief Parks the calling thread after removing it from its resident core's queue and inserts it on the core it's been awoken on
@@ -154,7 +169,7 @@ namespace skyline {
             }
 
             ~SchedulerScopedLock() {
-                state.scheduler->InsertThread(state.thread);
+                state.scheduler->InsertThread(state.thread.get());
                 state.scheduler->WaitSchedule();
             }
         };
@@ -114,7 +114,7 @@ namespace skyline::kernel::svc {
         }
 
         state.process->NewHandle<type::KPrivateMemory>(destination, size, chunk->permission, memory::states::Stack);
-        std::memcpy(destination, source, size);
+        state.process->memory.MapAlias(destination, source, size);
 
         auto object{state.process->GetMemoryObject(source)};
         if (!object)
@@ -169,12 +169,11 @@ namespace skyline::kernel::svc {
 
         destObject->item->UpdatePermission(destination, size, sourceChunk->permission);
 
-        std::memcpy(source, destination, size);
-
         auto sourceObject{state.process->GetMemoryObject(source)};
         if (!sourceObject)
             throw exception("svcUnmapMemory: Cannot find source memory object in handle table for address 0x{:X}", source);
 
+        state.process->memory.RestoreBacking(source, size); // Any writes to the alias were done directly to the memory backing the destination, so there's nothing to copy back
         state.process->CloseHandle(sourceObject->handle);
 
         state.logger->Debug("Unmapped range 0x{:X} - 0x{:X} to 0x{:X} - 0x{:X} (Size: 0x{:X} bytes)", source, source + size, destination, destination + size, size);
@@ -367,7 +366,7 @@ namespace skyline::kernel::svc {
                     newPriority = thread->priority.load();
                     newPriority = std::min(newPriority, priority);
                 } while (newPriority != priority && thread->priority.compare_exchange_strong(newPriority, priority));
-                state.scheduler->UpdatePriority(thread);
+                state.scheduler->UpdatePriority(thread.get());
                 thread->UpdatePriorityInheritance();
             }
             state.ctx->gpr.w0 = Result{};
@@ -435,12 +434,12 @@ namespace skyline::kernel::svc {
                 if (thread == state.thread) {
                     state.scheduler->RemoveThread();
                     thread->coreId = idealCore;
-                    state.scheduler->InsertThread(state.thread);
+                    state.scheduler->InsertThread(state.thread.get());
                     state.scheduler->WaitSchedule();
                 } else if (!thread->running) {
                     thread->coreId = idealCore;
                 } else {
-                    state.scheduler->UpdateCore(thread);
+                    state.scheduler->UpdateCore(thread.get());
                 }
             }
 
@@ -648,16 +647,16 @@ namespace skyline::kernel::svc {
 
         TRACE_EVENT_FMT("kernel", waitHandles.size() == 1 ? "WaitSynchronization 0x{:X}" : "WaitSynchronizationMultiple 0x{:X}", waitHandles[0]);
 
-        std::unique_lock lock(type::KSyncObject::syncObjectMutex);
-        if (state.thread->cancelSync) {
-            state.thread->cancelSync = false;
+        auto thread{state.thread.get()};
+        if (thread->cancelSync.exchange(false)) {
             state.ctx->gpr.w0 = result::Cancelled;
             return;
         }
 
+        // We can return without locking any objects if any of them is already signalled as we'd return the same result after locking them
         u32 index{};
         for (const auto &object : objectTable) {
-            if (object->signalled) {
+            if (object->signalled.load(std::memory_order_acquire)) {
                 state.logger->Debug("Signalled 0x{:X}", waitHandles[index]);
                 state.ctx->gpr.w0 = Result{};
                 state.ctx->gpr.w1 = index;
@@ -672,23 +671,61 @@ namespace skyline::kernel::svc {
             return;
         }
 
-        auto priority{state.thread->priority.load()};
+        // All objects are locked in ascending order of their address to avoid deadlocking with any other thread waiting on an overlapping set of objects
+        std::vector<type::KSyncObject *> lockOrder;
+        lockOrder.reserve(objectTable.size());
         for (const auto &object : objectTable)
-            object->syncObjectWaiters.insert(std::upper_bound(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), priority, type::KThread::IsHigherPriority), state.thread);
+            lockOrder.push_back(object.get());
+        std::sort(lockOrder.begin(), lockOrder.end());
+        lockOrder.erase(std::unique(lockOrder.begin(), lockOrder.end()), lockOrder.end());
+
+        for (auto object : lockOrder)
+            object->syncObjectMutex.lock();
 
-        state.thread->isCancellable = true;
-        state.thread->wakeObject = nullptr;
-        state.scheduler->RemoveThread();
+        auto unlockObjects{[&]() {
+            for (auto it{lockOrder.rbegin()}; it != lockOrder.rend(); it++)
+                (*it)->syncObjectMutex.unlock();
+        }};
 
-        lock.unlock();
+        index = 0;
+        for (const auto &object : objectTable) {
+            if (object->signalled) {
+                unlockObjects();
+                state.logger->Debug("Signalled 0x{:X}", waitHandles[index]);
+                state.ctx->gpr.w0 = Result{};
+                state.ctx->gpr.w1 = index;
+                return;
+            }
+            index++;
+        }
+
+        auto priority{thread->priority.load()};
+        for (const auto &object : objectTable)
+            object->syncObjectWaiters.insert(std::upper_bound(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), priority, type::KThread::IsHigherPriority), thread);
+
+        thread->wakeObject = nullptr;
+        state.scheduler->RemoveThread(); // This must be done prior to unlocking the objects as they could insert the thread into the scheduler queue as soon as they're unlocked
+        thread->isCancellable = true; // This must only be published after the thread has been removed from the scheduler queue, CancelSynchronization doesn't lock the objects and would otherwise insert the thread while it's still queued
+
+        if (thread->cancelSync && thread->isCancellable.exchange(false))
+            // CancelSynchronization could've been called after we checked for it but before we became cancellable, it'd have had no way of waking us up in that case
+            state.scheduler->InsertThread(thread);
+
+        unlockObjects();
+
+        bool timedOut{};
         if (timeout > 0)
-            state.scheduler->TimedWaitSchedule(std::chrono::nanoseconds(timeout));
+            timedOut = !state.scheduler->TimedWaitSchedule(std::chrono::nanoseconds(timeout));
         else
             state.scheduler->WaitSchedule(false);
-        lock.lock();
 
-        state.thread->isCancellable = false;
-        auto wakeObject{state.thread->wakeObject};
+        if (timedOut && !thread->isCancellable.exchange(false)) {
+            // If we timed out but another thread has already claimed waking us up, it'll insert us into the scheduler queue and we need to wait till we're scheduled
+            timedOut = false;
+            state.scheduler->WaitSchedule(false);
+        }
+
+        auto wakeObject{thread->wakeObject};
 
         u32 wakeIndex{};
         index = 0;
@@ -696,7 +733,8 @@ namespace skyline::kernel::svc {
             if (object.get() == wakeObject)
                 wakeIndex = index;
 
-            auto it{std::find(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), state.thread)};
+            std::lock_guard lock(object->syncObjectMutex);
+            auto it{std::find(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), thread)};
             if (it != object->syncObjectWaiters.end())
                 object->syncObjectWaiters.erase(it);
             else
@@ -709,28 +747,23 @@ namespace skyline::kernel::svc {
             state.logger->Debug("Signalled 0x{:X}", waitHandles[wakeIndex]);
             state.ctx->gpr.w0 = Result{};
             state.ctx->gpr.w1 = wakeIndex;
-        } else if (state.thread->cancelSync) {
-            state.thread->cancelSync = false;
+        } else if (!timedOut && thread->cancelSync.exchange(false)) {
             state.logger->Debug("Wait has been cancelled");
             state.ctx->gpr.w0 = result::Cancelled;
         } else {
             state.logger->Debug("Wait has timed out");
             state.ctx->gpr.w0 = result::TimedOut;
-            lock.unlock();
-            state.scheduler->InsertThread(state.thread);
+            state.scheduler->InsertThread(thread);
             state.scheduler->WaitSchedule();
         }
     }
 
     void CancelSynchronization(const DeviceState &state) {
         try {
-            std::unique_lock lock(type::KSyncObject::syncObjectMutex);
             auto thread{state.process->GetHandle<type::KThread>(state.ctx->gpr.w0)};
             thread->cancelSync = true;
-            if (thread->isCancellable) {
-                thread->isCancellable = false;
-                state.scheduler->InsertThread(thread);
-            }
+            if (thread->isCancellable.exchange(false))
+                state.scheduler->InsertThread(thread.get());
             state.ctx->gpr.w0 = Result{};
         } catch (const std::out_of_range &) {
             state.logger->Warn("'handle' invalid: 0x{:X}", static_cast<u32>(state.ctx->gpr.w0));
@@ -952,6 +985,8 @@ namespace skyline::kernel::svc {
 
             case InfoState::TotalMemoryUsage:
                 out = state.process->memory.GetUserMemoryUsage() + state.process->memory.GetSystemResourceUsage();
+                if (Logger::LogLevel::Debug <= state.logger->configLevel)
+                    state.logger->Debug("Resident memory: 0x{:X} bytes", state.process->memory.GetResidentMemoryUsage());
                 break;
 
             case InfoState::RandomEntropy:
@@ -993,6 +1028,8 @@ namespace skyline::kernel::svc {
 
             case InfoState::TotalMemoryUsageWithoutSystemResource:
                 out = state.process->memory.GetUserMemoryUsage();
+                if (Logger::LogLevel::Debug <= state.logger->configLevel)
+                    state.logger->Debug("Resident memory: 0x{:X} bytes", state.process->memory.GetResidentMemoryUsage());
                 break;
 
             case InfoState::UserExceptionContextAddr:
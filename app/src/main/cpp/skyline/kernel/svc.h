@@ -241,6 +241,7 @@ namespace skyline::kernel::svc {
     struct SvcDescriptor {
         void (*function)(const DeviceState &); //!< A function pointer to a HLE implementation of the SVC
         const char* name; //!< A pointer to a static string of the SVC name, the underlying data should not be mutated
+        u8 registers; //!< The amount of registers starting from X0 which the SVC uses for arguments or results, only these are saved and restored around the SVC
 
         operator bool() {
             return function;
@@ -249,66 +250,66 @@ namespace skyline::kernel::svc {
 
     #define SVC_NONE SvcDescriptor{} //!< A macro with a placeholder value for the SVC not being implemented or not existing
     #define SVC_STRINGIFY(name) #name
-    #define SVC_ENTRY(function) SvcDescriptor{function, SVC_STRINGIFY(Svc ## function)} //!< A macro which automatically stringifies the function name as the name to prevent pointless duplication
+    #define SVC_ENTRY(function, registers) SvcDescriptor{function, SVC_STRINGIFY(Svc ## function), registers} //!< A macro which automatically stringifies the function name as the name to prevent pointless duplication
 
     /**
      * @brief The SVC table maps all SVCs to their corresponding functions
      */
     static constexpr std::array<SvcDescriptor, 0x80> SvcTable{
         SVC_NONE, // 0x00 (Does not exist)
-        SVC_ENTRY(SetHeapSize), // 0x01
+        SVC_ENTRY(SetHeapSize, 2), // 0x01
         SVC_NONE, // 0x02
-        SVC_ENTRY(SetMemoryAttribute), // 0x03
-        SVC_ENTRY(MapMemory), // 0x04
-        SVC_ENTRY(UnmapMemory), // 0x05
-        SVC_ENTRY(QueryMemory), // 0x06
-        SVC_ENTRY(ExitProcess), // 0x07
-        SVC_ENTRY(CreateThread), // 0x08
-        SVC_ENTRY(StartThread), // 0x09
-        SVC_ENTRY(ExitThread), // 0x0A
-        SVC_ENTRY(SleepThread), // 0x0B
-        SVC_ENTRY(GetThreadPriority), // 0x0C
-        SVC_ENTRY(SetThreadPriority), // 0x0D
-        SVC_ENTRY(GetThreadCoreMask), // 0x0E
-        SVC_ENTRY(SetThreadCoreMask), // 0x0F
-        SVC_ENTRY(GetCurrentProcessorNumber), // 0x10
+        SVC_ENTRY(SetMemoryAttribute, 4), // 0x03
+        SVC_ENTRY(MapMemory, 3), // 0x04
+        SVC_ENTRY(UnmapMemory, 3), // 0x05
+        SVC_ENTRY(QueryMemory, 3), // 0x06
+        SVC_ENTRY(ExitProcess, 0), // 0x07
+        SVC_ENTRY(CreateThread, 6), // 0x08
+        SVC_ENTRY(StartThread, 1), // 0x09
+        SVC_ENTRY(ExitThread, 0), // 0x0A
+        SVC_ENTRY(SleepThread, 1), // 0x0B
+        SVC_ENTRY(GetThreadPriority, 2), // 0x0C
+        SVC_ENTRY(SetThreadPriority, 2), // 0x0D
+        SVC_ENTRY(GetThreadCoreMask, 3), // 0x0E
+        SVC_ENTRY(SetThreadCoreMask, 3), // 0x0F
+        SVC_ENTRY(GetCurrentProcessorNumber, 1), // 0x10
         SVC_NONE, // 0x11
-        SVC_ENTRY(ClearEvent), // 0x12
-        SVC_ENTRY(MapSharedMemory), // 0x13
-        SVC_ENTRY(UnmapSharedMemory), // 0x14
-        SVC_ENTRY(CreateTransferMemory), // 0x15
-        SVC_ENTRY(CloseHandle), // 0x16
-        SVC_ENTRY(ResetSignal), // 0x17
-        SVC_ENTRY(WaitSynchronization), // 0x18
-        SVC_ENTRY(CancelSynchronization), // 0x19
-        SVC_ENTRY(ArbitrateLock), // 0x1A
-        SVC_ENTRY(ArbitrateUnlock), // 0x1B
-        SVC_ENTRY(WaitProcessWideKeyAtomic), // 0x1C
-        SVC_ENTRY(SignalProcessWideKey), // 0x1D
-        SVC_ENTRY(GetSystemTick), // 0x1E
-        SVC_ENTRY(ConnectToNamedPort), // 0x1F
+        SVC_ENTRY(ClearEvent, 1), // 0x12
+        SVC_ENTRY(MapSharedMemory, 4), // 0x13
+        SVC_ENTRY(UnmapSharedMemory, 3), // 0x14
+        SVC_ENTRY(CreateTransferMemory, 4), // 0x15
+        SVC_ENTRY(CloseHandle, 1), // 0x16
+        SVC_ENTRY(ResetSignal, 1), // 0x17
+        SVC_ENTRY(WaitSynchronization, 4), // 0x18
+        SVC_ENTRY(CancelSynchronization, 1), // 0x19
+        SVC_ENTRY(ArbitrateLock, 3), // 0x1A
+        SVC_ENTRY(ArbitrateUnlock, 1), // 0x1B
+        SVC_ENTRY(WaitProcessWideKeyAtomic, 4), // 0x1C
+        SVC_ENTRY(SignalProcessWideKey, 2), // 0x1D
+        SVC_ENTRY(GetSystemTick, 1), // 0x1E
+        SVC_ENTRY(ConnectToNamedPort, 2), // 0x1F
         SVC_NONE, // 0x20
-        SVC_ENTRY(SendSyncRequest), // 0x21
+        SVC_ENTRY(SendSyncRequest, 1), // 0x21
         SVC_NONE, // 0x22
         SVC_NONE, // 0x23
         SVC_NONE, // 0x24
-        SVC_ENTRY(GetThreadId), // 0x25
-        SVC_ENTRY(Break), // 0x26
-        SVC_ENTRY(OutputDebugString), // 0x27
+        SVC_ENTRY(GetThreadId, 2), // 0x25
+        SVC_ENTRY(Break, 1), // 0x26
+        SVC_ENTRY(OutputDebugString, 2), // 0x27
         SVC_NONE, // 0x28
-        SVC_ENTRY(GetInfo), // 0x29
+        SVC_ENTRY(GetInfo, 4), // 0x29
         SVC_NONE, // 0x2A
         SVC_NONE, // 0x2B
-        SVC_ENTRY(MapPhysicalMemory), // 0x2C
-        SVC_ENTRY(UnmapPhysicalMemory), // 0x2D
+        SVC_ENTRY(MapPhysicalMemory, 2), // 0x2C
+        SVC_ENTRY(UnmapPhysicalMemory, 2), // 0x2D
         SVC_NONE, // 0x2E
         SVC_NONE, // 0x2F
         SVC_NONE, // 0x30
         SVC_NONE, // 0x31
         SVC_NONE, // 0x32
         SVC_NONE, // 0x33
-        SVC_ENTRY(WaitForAddress), // 0x34
-        SVC_ENTRY(SignalToAddress), // 0x35
+        SVC_ENTRY(WaitForAddress, 4), // 0x34
+        SVC_ENTRY(SignalToAddress, 4), // 0x35
         SVC_NONE, // 0x36
         SVC_NONE, // 0x37
         SVC_NONE, // 0x38
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "svc.h"
+#include "svc_statistics.h"
+
+namespace skyline::kernel::svc {
+    static std::atomic<u64> nextInstanceId{1}; //!< The ID for the next instance of SvcStatistics, 0 is reserved for threads without any statistics
+
+    SvcStatistics::SvcStatistics() : instanceId(nextInstanceId.fetch_add(1, std::memory_order_relaxed)) {}
+
+    std::array<LatencyHistogram::Snapshot, SvcStatistics::SvcCount> SvcStatistics::GetSnapshot() {
+        std::array<LatencyHistogram::Snapshot, SvcCount> snapshot{};
+        std::lock_guard guard(mutex);
+        for (const auto &thread : threads)
+            for (size_t svcId{}; svcId < SvcCount; svcId++)
+                snapshot[svcId].Merge(thread[svcId].GetSnapshot());
+        return snapshot;
+    }
+
+    void SvcStatistics::Dump(Logger &logger) {
+        auto snapshot{GetSnapshot()};
+
+        std::string statistics;
+        for (size_t svcId{}; svcId < SvcCount; svcId++) {
+            const auto &svc{snapshot[svcId]};
+            if (svc.count)
+                statistics += fmt::format("\n* {} (0x{:02X}): {} calls, Mean: {}ns, P50: <{}ns, P99: <{}ns, Max: {}ns", SvcTable[svcId].name ? SvcTable[svcId].name : "Unknown", svcId, svc.count, svc.Mean(), svc.Percentile(50), svc.Percentile(99), svc.max);
+        }
+
+        if (!statistics.empty())
+            logger.Info("SVC Statistics:{}", statistics);
+    }
+}
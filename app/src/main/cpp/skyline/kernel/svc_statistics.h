@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common/histogram.h>
+
+namespace skyline::kernel::svc {
+    /**
+     * @brief Call counts and latency histograms for every SVC, they're recorded into storage local to each thread to avoid contention and merged when read
+     * @note SVCs which are entirely handled by their fast path in guest code don't reach the SVC handler and aren't recorded
+     */
+    class SvcStatistics {
+      private:
+        static constexpr size_t SvcCount{0x80}; //!< The amount of SVC IDs, this is the same as the size of the SVC table
+
+        using ThreadStatistics = std::array<LatencyHistogram, SvcCount>;
+
+        std::mutex mutex; //!< Synchronizes access to 'threads'
+        std::list<ThreadStatistics> threads; //!< The statistics of every thread that has called an SVC, they're retained after the thread exits
+        u64 instanceId; //!< A unique ID for this instance, it's used to detect thread-local statistics that belong to a prior instance
+
+        static thread_local inline std::pair<u64, ThreadStatistics *> threadStatistics{}; //!< The instance ID and statistics of the calling thread
+
+      public:
+        SvcStatistics();
+
+        /**
+         * @brief Records a single call to an SVC on the calling thread
+         * @param latency The time spent in the HLE implementation of the SVC in nanoseconds
+         */
+        void Record(u16 svcId, u64 latency) {
+            auto [id, statistics]{threadStatistics};
+            if (id != instanceId) [[unlikely]] {
+                std::lock_guard guard(mutex);
+                statistics = &threads.emplace_back();
+                threadStatistics = {instanceId, statistics};
+            }
+            (*statistics)[svcId].Record(latency);
+        }
+
+        /**
+         * @return The statistics of every SVC merged across all threads
+         */
+        std::array<LatencyHistogram::Snapshot, SvcCount> GetSnapshot();
+
+        /**
+         * @brief Writes the statistics of all SVCs that have been called to the log
+         */
+        void Dump(Logger &logger);
+    };
+}
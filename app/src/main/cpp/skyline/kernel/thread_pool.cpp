@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <unistd.h>
+#include <common/signal.h>
+#include <nce.h>
+#include <kernel/profiler.h>
+#include "types/KThread.h"
+#include "thread_pool.h"
+
+namespace skyline::kernel {
+    ThreadPool::ThreadPool(const DeviceState &state) : state(state) {
+        std::lock_guard lock(mutex);
+        for (size_t index{}; index < InitialThreadCount; index++)
+            idleThreads.push_back(&SpawnThread());
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex);
+            exiting = true;
+            for (auto &host : hostThreads)
+                host.condition.notify_one();
+        }
+
+        for (auto &host : hostThreads)
+            if (host.thread.joinable())
+                host.thread.join();
+    }
+
+    ThreadPool::HostThread &ThreadPool::SpawnThread() {
+        auto &host{hostThreads.emplace_back()};
+        host.thread = std::thread(&ThreadPool::Run, this, std::ref(host));
+        return host;
+    }
+
+    void ThreadPool::Run(HostThread &host) {
+        constexpr const char *IdleThreadName{"HOS-Idle"}; // This has the same prefix as guest threads so KThread::StartThread won't try to restore it
+        pthread_setname_np(pthread_self(), IdleThreadName);
+
+        struct sigevent event{
+            .sigev_signo = Scheduler::PreemptionSignal,
+            .sigev_notify = SIGEV_THREAD_ID,
+            .sigev_notify_thread_id = gettid(),
+        };
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &host.preemptionTimer))
+            throw exception("timer_create has failed with '{}'", strerror(errno));
+
+        signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, nce::NCE::SignalHandler);
+        signal::SetSignalHandler({Scheduler::YieldSignal, Scheduler::PreemptionSignal}, Scheduler::SignalHandler, false); // We want futexes to fail and their predicates rechecked
+        signal::SetSignalHandler({Profiler::ProfilerSignal}, Profiler::SignalHandler);
+        signal::Sigprocmask(SIG_BLOCK, sigset_t{}, &host.signalMask);
+
+        std::unique_lock lock(mutex);
+        while (true) {
+            if (!host.condition.wait_for(lock, IdleTimeout, [&]() { return host.guest || exiting; })) {
+                if (hostThreads.size() <= InitialThreadCount)
+                    continue;
+
+                // We've been idle for long enough while there are more host threads than we initially created, this host thread is trimmed from the pool
+                idleThreads.erase(std::find(idleThreads.begin(), idleThreads.end(), &host));
+                timer_delete(host.preemptionTimer);
+                host.thread.detach();
+                hostThreads.remove_if([&](const HostThread &thread) { return &thread == &host; }); // Note: 'host' is destroyed at this point and must not be accessed
+                return;
+            }
+
+            if (!host.guest)
+                break;
+
+            auto guest{host.guest};
+            lock.unlock();
+
+            state.logger->Debug("Attached thread #{} to a pooled host thread after {}ns", guest->id, util::GetTimeNs() - host.attachTimestamp);
+
+            guest->preemptionTimer = host.preemptionTimer;
+            Scheduler::YieldPending = false; // A preemption signal may have been delivered to this host thread after the last guest thread on it had exited
+            guest->StartThread();
+
+            // The guest thread has exited at this point, we need to reset any state that it could've changed and drop our references to it
+            guest->preemptionTimer = {};
+            state.thread = nullptr;
+            state.ctx = nullptr;
+            signal::Sigprocmask(SIG_SETMASK, host.signalMask);
+            pthread_setname_np(pthread_self(), IdleThreadName);
+            state.logger->UpdateTag();
+
+            lock.lock();
+            host.guest = nullptr;
+            idleThreads.push_back(&host);
+        }
+
+        timer_delete(host.preemptionTimer);
+    }
+
+    void ThreadPool::Attach(type::KThread *thread) {
+        std::lock_guard lock(mutex);
+
+        HostThread *host;
+        if (!idleThreads.empty()) {
+            host = idleThreads.back();
+            idleThreads.pop_back();
+        } else {
+            host = &SpawnThread();
+        }
+
+        host->guest = thread;
+        host->attachTimestamp = util::GetTimeNs();
+        host->condition.notify_one();
+    }
+}
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <csignal>
+#include <condition_variable>
+#include <common.h>
+
+namespace skyline::kernel {
+    /**
+     * @brief A pool of host threads which guest threads are attached to when they're started, this avoids the cost of creating and initializing a host thread for every guest thread
+     * @note Host threads are initialized once with their name, signal handlers and preemption timer and retain those across all guest threads that run on them
+     * @note Host threads created beyond InitialThreadCount to handle bursts of guest threads exit after being idle for IdleTimeout
+     */
+    class ThreadPool {
+      private:
+        const DeviceState &state;
+
+        /**
+         * @brief A single host thread in the pool and the state that it persists across guest threads
+         */
+        struct HostThread {
+            std::thread thread;
+            timer_t preemptionTimer{}; //!< A kernel timer that delivers preemption signals to this host thread, it's lent to every guest thread run on it
+            sigset_t signalMask{}; //!< The signal mask of the host thread after initialization, it's restored after every guest thread as they may block signals on exit
+            std::condition_variable condition; //!< Signalled when a guest thread has been attached to this host thread or the pool is being destroyed
+            type::KThread *guest{}; //!< The guest thread that has been attached to this host thread, if any
+            u64 attachTimestamp{}; //!< A timestamp in nanoseconds of when the guest thread was attached, this is used to report the start latency
+        };
+
+        std::mutex mutex; //!< Synchronizes all operations on the pool and the 'guest' member of all host threads
+        std::list<HostThread> hostThreads; //!< All host threads in the pool, a std::list is used as references to them need to be stable and trimmed host threads are removed from it
+        std::vector<HostThread *> idleThreads; //!< Host threads which don't have any guest thread attached to them
+        bool exiting{}; //!< If the pool is being destroyed and all host threads should exit once they're idle
+
+        /**
+         * @brief The entry point of all host threads in the pool, it initializes the host thread and runs any guest threads that are attached to it
+         */
+        void Run(HostThread &host);
+
+        /**
+         * @brief Creates a new host thread in the pool
+         * @note 'mutex' **must** be locked by the calling thread prior to calling this
+         */
+        HostThread &SpawnThread();
+
+      public:
+        static constexpr size_t InitialThreadCount{4}; //!< The amount of host threads which are created along with the pool in anticipation of guest threads, the pool isn't trimmed below this
+        static constexpr std::chrono::seconds IdleTimeout{10}; //!< The duration after which an idle host thread exits if there are more than InitialThreadCount host threads
+
+        ThreadPool(const DeviceState &state);
+
+        /**
+         * @note All guest threads must have exited prior to the pool being destroyed, this will block till they have
+         */
+        ~ThreadPool();
+
+        /**
+         * @brief Runs the supplied guest thread on an idle host thread, a new host thread is created if there are none
+         */
+        void Attach(type::KThread *thread);
+    };
+}
@@ -21,6 +21,7 @@ namespace skyline::kernel::type {
 
     /**
      * @brief A base class that all Kernel objects have to derive from
+     * @note Kernel objects are owned through std::shared_ptr by the handle table, their process and services, structures that only reference an object while its lifetime is guaranteed by one of those (such as the scheduler queues and waiter lists holding KThread) hold borrowed raw pointers instead of copies
      */
     class KObject {
       public:
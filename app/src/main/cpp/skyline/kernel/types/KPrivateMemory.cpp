@@ -8,6 +8,16 @@
 #include "KProcess.h"
 
 namespace skyline::kernel::type {
+    constexpr size_t HugePageSize{0x200000}; //!< The size of a huge page on the host, heap mappings at least this large are hinted to be backed by huge pages
+
+    /**
+     * @brief Hints that a heap mapping should be backed by transparent huge pages, the host may ignore this if it doesn't support them
+     */
+    static void AdviseHugePages(u8 *ptr, size_t size, memory::MemoryState memState) {
+        if (memState == memory::states::Heap && size >= HugePageSize)
+            madvise(ptr, size, MADV_HUGEPAGE);
+    }
+
     KPrivateMemory::KPrivateMemory(const DeviceState &state, u8 *ptr, size_t size, memory::Permission permission, memory::MemoryState memState) : ptr(ptr), size(size), permission(permission), memoryState(memState), KMemory(state, KType::KPrivateMemory) {
         if (!state.process->memory.base.IsInside(ptr) || !state.process->memory.base.IsInside(ptr + size))
             throw exception("KPrivateMemory allocation isn't inside guest address space: 0x{:X} - 0x{:X}", ptr, ptr + size);
@@ -16,6 +26,8 @@ namespace skyline::kernel::type {
 
         if (mprotect(ptr, size, PROT_READ | PROT_WRITE | PROT_EXEC) < 0) // We only need to reprotect as the allocation has already been reserved by the MemoryManager
             throw exception("An occurred while mapping private memory: {} with 0x{:X} @ 0x{:X}", strerror(errno), ptr, size);
+        AdviseHugePages(ptr, size, memState); // Memory isn't committed here, it's committed as zero-filled pages on the first access to it
+        allocation.Resize(size);
 
         state.process->memory.InsertChunk(ChunkDescriptor{
             .ptr = ptr,
@@ -30,12 +42,18 @@ namespace skyline::kernel::type {
             throw exception("An occurred while resizing private memory: {}", strerror(errno));
 
         if (nSize < size) {
+            state.process->memory.FreeMemory(ptr + nSize, size - nSize);
+            if (mprotect(ptr + nSize, size - nSize, PROT_NONE) < 0)
+                throw exception("An occurred while resizing private memory: {}", strerror(errno));
+
             state.process->memory.InsertChunk(ChunkDescriptor{
                 .ptr = ptr + nSize,
                 .size = size - nSize,
                 .state = memory::states::Unmapped,
             });
         } else if (size < nSize) {
+            AdviseHugePages(ptr + size, nSize - size, memoryState);
+
             state.process->memory.InsertChunk(ChunkDescriptor{
                 .ptr = ptr + size,
                 .size = nSize - size,
@@ -45,6 +63,7 @@ namespace skyline::kernel::type {
         }
 
         size = nSize;
+        allocation.Resize(size);
     }
 
     void KPrivateMemory::Remap(u8 *nPtr, size_t nSize) {
@@ -80,6 +99,7 @@ namespace skyline::kernel::type {
     }
 
     KPrivateMemory::~KPrivateMemory() {
+        state.process->memory.FreeMemory(ptr, size);
         mprotect(ptr, size, PROT_NONE);
         state.process->memory.InsertChunk(ChunkDescriptor{
             .ptr = ptr,
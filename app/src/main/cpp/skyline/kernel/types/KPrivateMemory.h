@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <common/memory_accounting.h>
 #include "KMemory.h"
 
 namespace skyline::kernel::type {
@@ -16,6 +17,7 @@ namespace skyline::kernel::type {
         size_t size{};
         memory::Permission permission;
         memory::MemoryState memoryState;
+        accounting::Allocation allocation{accounting::Category::GuestPrivate}; //!< The attribution of the mapping to guest private memory, this follows 'size'
 
         /**
          * @param permission The permissions for the allocated memory (As reported to the application, host memory permissions aren't reflected by this)
@@ -16,7 +16,7 @@ namespace skyline::kernel::type {
         return memory->ptr + (constant::TlsSlotSize * index++);
     }
 
-    KProcess::KProcess(const DeviceState &state) : memory(state), KSyncObject(state, KType::KProcess) {}
+    KProcess::KProcess(const DeviceState &state) : memory(state), threadPool(state), KSyncObject(state, KType::KProcess) {}
 
     KProcess::~KProcess() {
         std::lock_guard guard(threadMutex);
@@ -79,10 +79,13 @@ namespace skyline::kernel::type {
     }
 
     std::optional<KProcess::HandleOut<KMemory>> KProcess::GetMemoryObject(u8 *ptr) {
-        std::shared_lock lock(handleMutex);
+        size_t slotCount{handleSlotsUsed.load(std::memory_order_acquire)};
+        for (size_t index{}; index < slotCount; index++) {
+            auto handle{handleSlots[index].handle.load(std::memory_order_acquire)};
+            if (!handle)
+                continue;
 
-        for (KHandle index{}; index < handles.size(); index++) {
-            auto &object{handles[index]};
+            auto object{LookupHandle(handle)};
             if (object) {
                 switch (object->objectType) {
                     case type::KType::KPrivateMemory:
@@ -90,7 +93,7 @@ namespace skyline::kernel::type {
                     case type::KType::KTransferMemory: {
                         auto mem{std::static_pointer_cast<type::KMemory>(object)};
                         if (mem->IsInside(ptr))
-                            return std::make_optional<KProcess::HandleOut<KMemory>>({mem, constant::BaseHandleIndex + index});
+                            return std::make_optional<KProcess::HandleOut<KMemory>>({mem, handle});
                     }
 
                     default:
@@ -101,6 +104,26 @@ namespace skyline::kernel::type {
         return std::nullopt;
     }
 
+    void KProcess::CloseHandle(KHandle handle) {
+        std::shared_ptr<KObject> object;
+        {
+            std::lock_guard lock(handleMutex);
+
+            size_t index{(handle & ((1U << constant::HandleGenerationShift) - 1)) - constant::BaseHandleIndex};
+            if (index >= constant::MaxHandleCount || handleSlots[index].handle.load(std::memory_order_relaxed) != handle)
+                throw std::out_of_range(fmt::format("CloseHandle was called with an invalid or closed handle: 0x{:X}", handle));
+
+            auto &slot{handleSlots[index]};
+            slot.handle.store(0, std::memory_order_seq_cst);
+            while (slot.readers.load(std::memory_order_seq_cst)) // Any lookup that observed the handle prior to it being cleared is still copying the object
+                std::this_thread::yield();
+            object = std::move(slot.object);
+            slot.generation = (slot.generation + 1) & constant::HandleGenerationMask;
+            freeHandleSlots.push_back(static_cast<u16>(index));
+        }
+        // The object is destroyed here (if this was the last reference to it) after the handle table has been unlocked
+    }
+
     constexpr u32 HandleWaitersBit{1UL << 30}; //!< A bit which denotes if a mutex psuedo-handle has waiters or not
 
     Result KProcess::MutexLock(u32 *mutex, KHandle ownerHandle, KHandle tag) {
@@ -129,10 +152,10 @@ namespace skyline::kernel::type {
                 return result::InvalidCurrentMemory;
 
             auto &waiters{owner->waiters};
-            isHighestPriority = waiters.insert(std::upper_bound(waiters.begin(), waiters.end(), state.thread->priority.load(), KThread::IsHigherPriority), state.thread) == waiters.begin();
+            isHighestPriority = waiters.insert(std::upper_bound(waiters.begin(), waiters.end(), state.thread->priority.load(), KThread::IsHigherPriority), state.thread.get()) == waiters.begin();
             state.scheduler->RemoveThread();
 
-            state.thread->waitThread = owner;
+            state.thread->waitThread = owner.get();
             state.thread->waitKey = mutex;
             state.thread->waitTag = tag;
         }
@@ -151,15 +174,15 @@ namespace skyline::kernel::type {
 
         std::lock_guard lock(state.thread->waiterMutex);
         auto &waiters{state.thread->waiters};
-        auto nextOwnerIt{std::find_if(waiters.begin(), waiters.end(), [mutex](const std::shared_ptr<KThread> &thread) { return thread->waitKey == mutex; })};
+        auto nextOwnerIt{std::find_if(waiters.begin(), waiters.end(), [mutex](const KThread *thread) { return thread->waitKey == mutex; })};
         if (nextOwnerIt != waiters.end()) {
             auto nextOwner{*nextOwnerIt};
             std::lock_guard nextLock(nextOwner->waiterMutex);
-            nextOwner->waitThread = std::shared_ptr<KThread>{nullptr};
+            nextOwner->waitThread = nullptr;
             nextOwner->waitKey = nullptr;
 
             // Move all threads waiting on this key to the next owner's waiter list
-            std::shared_ptr<KThread> nextWaiter{};
+            KThread *nextWaiter{};
             for (auto it{waiters.erase(nextOwnerIt)}, nextIt{std::next(it)}; it != waiters.end(); it = nextIt++) {
                 auto thread{*it};
                 if (thread->waitKey == mutex) {
@@ -178,7 +201,7 @@ namespace skyline::kernel::type {
                     basePriority = state.thread->basePriority.load();
                     newPriority = std::min(basePriority, highestPriorityThread->priority.load());
                 } while (basePriority != newPriority && state.thread->priority.compare_exchange_strong(basePriority, newPriority));
-                state.scheduler->UpdatePriority(state.thread);
+                state.scheduler->UpdatePriority(state.thread.get());
             } else {
                 u8 priority, basePriority;
                 do {
@@ -186,7 +209,7 @@ namespace skyline::kernel::type {
                     priority = state.thread->priority.load();
                 } while (priority != basePriority && !state.thread->priority.compare_exchange_strong(priority, basePriority));
                 if (priority != basePriority)
-                    state.scheduler->UpdatePriority(state.thread);
+                    state.scheduler->UpdatePriority(state.thread.get());
             }
 
             if (nextWaiter) {
@@ -209,13 +232,133 @@ namespace skyline::kernel::type {
         }
     }
 
+    KThread *KProcess::FindSyncWaiters(SyncWaiterBucket &bucket, void *key) {
+        for (auto head{bucket.head}; head; head = head->syncKeyNext)
+            if (head->syncWaitKey == key)
+                return head;
+        return nullptr;
+    }
+
+    void KProcess::ReplaceSyncWaiterHead(SyncWaiterBucket &bucket, KThread *head, KThread *replacement) {
+        auto previous{head->syncKeyPrevious}, next{head->syncKeyNext};
+        if (replacement) {
+            replacement->syncWaitTail = head->syncWaitTail;
+            replacement->syncWaitCount = head->syncWaitCount;
+            replacement->syncKeyPrevious = previous;
+            replacement->syncKeyNext = next;
+            if (next)
+                next->syncKeyPrevious = replacement;
+        } else if (next) {
+            next->syncKeyPrevious = previous;
+        }
+
+        auto link{replacement ? replacement : next};
+        if (previous)
+            previous->syncKeyNext = link;
+        else
+            bucket.head = link;
+
+        head->syncWaitTail = head->syncKeyPrevious = head->syncKeyNext = nullptr;
+        head->syncWaitCount = 0;
+    }
+
+    void KProcess::InsertSyncWaiter(SyncWaiterBucket &bucket, void *key) {
+        auto thread{state.thread.get()};
+        thread->syncWaitKey = key;
+        thread->syncWaitPrevious = thread->syncWaitNext = nullptr;
+
+        auto head{FindSyncWaiters(bucket, key)};
+        if (!head) {
+            // The thread is the only waiter on the key, it starts a new queue at the front of the bucket
+            thread->syncWaitTail = thread;
+            thread->syncWaitCount = 1;
+            thread->syncKeyPrevious = nullptr;
+            thread->syncKeyNext = bucket.head;
+            if (bucket.head)
+                bucket.head->syncKeyPrevious = thread;
+            bucket.head = thread;
+            return;
+        }
+
+        // The thread is inserted after all threads of a higher or equal priority, matching std::upper_bound
+        auto priority{thread->priority.load()};
+        KThread *next{head};
+        while (next && !KThread::IsHigherPriority(priority, next))
+            next = next->syncWaitNext;
+
+        if (next == head) {
+            ReplaceSyncWaiterHead(bucket, head, thread);
+            head = thread;
+        }
+
+        thread->syncWaitNext = next;
+        thread->syncWaitPrevious = next ? next->syncWaitPrevious : head->syncWaitTail;
+        if (thread->syncWaitPrevious)
+            thread->syncWaitPrevious->syncWaitNext = thread;
+        if (next)
+            next->syncWaitPrevious = thread;
+        else
+            head->syncWaitTail = thread;
+        head->syncWaitCount++;
+    }
+
+    bool KProcess::RemoveSyncWaiter(SyncWaiterBucket &bucket, void *key) {
+        auto thread{state.thread.get()};
+        if (thread->syncWaitKey != key)
+            return false; // The thread has already been removed from the queue by a signal
+
+        UnlinkSyncWaiter(bucket, thread);
+        return true;
+    }
+
+    void KProcess::UnlinkSyncWaiter(SyncWaiterBucket &bucket, KThread *thread) {
+        // Only the first thread of a queue has no previous thread, the queue needs to be looked up for any other thread to update its tail and count
+        auto head{thread->syncWaitPrevious ? FindSyncWaiters(bucket, thread->syncWaitKey) : thread};
+        auto next{thread->syncWaitNext};
+        if (thread == head) {
+            ReplaceSyncWaiterHead(bucket, thread, next);
+            head = next;
+            if (next)
+                next->syncWaitPrevious = nullptr;
+        } else {
+            thread->syncWaitPrevious->syncWaitNext = next;
+            if (next)
+                next->syncWaitPrevious = thread->syncWaitPrevious;
+            else
+                head->syncWaitTail = thread->syncWaitPrevious;
+        }
+        if (head)
+            head->syncWaitCount--;
+
+        thread->syncWaitPrevious = thread->syncWaitNext = nullptr;
+        thread->syncWaitKey = nullptr;
+    }
+
+    size_t KProcess::CountSyncWaiters(SyncWaiterBucket &bucket, void *key) {
+        auto head{FindSyncWaiters(bucket, key)};
+        return head ? head->syncWaitCount : 0;
+    }
+
+    void KProcess::WakeSyncWaiters(SyncWaiterBucket &bucket, void *key, i32 amount) {
+        // Threads are always woken from the front of the queue, unlinking them doesn't require looking up the queue again
+        bool wakeAll{amount <= 0};
+        for (auto thread{FindSyncWaiters(bucket, key)}; thread && (wakeAll || amount);) {
+            auto next{thread->syncWaitNext};
+            UnlinkSyncWaiter(bucket, thread);
+            state.scheduler->InsertThread(thread);
+            if (!wakeAll)
+                amount--;
+            thread = next;
+        }
+    }
+
     Result KProcess::ConditionalVariableWait(u32 *key, u32 *mutex, KHandle tag, i64 timeout) {
         TRACE_EVENT_FMT("kernel", "ConditionalVariableWait 0x{:X} (0x{:X})", key, mutex);
 
+        auto &bucket{GetSyncWaiterBucket(key)};
         {
-            std::lock_guard lock(syncWaiterMutex);
-            auto queue{syncWaiters.equal_range(key)};
-            syncWaiters.insert(std::upper_bound(queue.first, queue.second, state.thread->priority.load(), [](const i8 priority, const SyncWaiters::value_type &it) { return it.second->priority > priority; }), {key, state.thread});
+            std::lock_guard lock(bucket.mutex);
+            InsertSyncWaiter(bucket, key);
 
             __atomic_store_n(key, true, __ATOMIC_SEQ_CST); // We need to notify any userspace threads that there are waiters on this conditional variable by writing back a boolean flag denoting it
 
@@ -224,21 +367,22 @@ namespace skyline::kernel::type {
         }
 
         if (timeout > 0 && !state.scheduler->TimedWaitSchedule(std::chrono::nanoseconds(timeout))) {
-            std::unique_lock lock(syncWaiterMutex);
-            auto queue{syncWaiters.equal_range(key)};
-            auto iterator{std::find(queue.first, queue.second, SyncWaiters::value_type{key, state.thread})};
-            if (iterator != queue.second)
-                if (syncWaiters.erase(iterator) == queue.second)
+            std::unique_lock lock(bucket.mutex);
+            if (RemoveSyncWaiter(bucket, key)) {
+                if (!CountSyncWaiters(bucket, key))
                     __atomic_store_n(key, false, __ATOMIC_SEQ_CST);
 
-            lock.unlock();
-            state.scheduler->InsertThread(state.thread);
-            state.scheduler->WaitSchedule();
+                lock.unlock();
+                state.scheduler->InsertThread(state.thread.get());
+                state.scheduler->WaitSchedule();
 
-            return result::TimedOut;
-        } else {
-            state.scheduler->WaitSchedule(false);
+                return result::TimedOut;
+            }
+
+            // If we were signalled after the timeout expired then we've already been inserted into the scheduler queue by the signalling thread
+            lock.unlock();
         }
+        state.scheduler->WaitSchedule(false);
 
         KHandle value{};
         if (!__atomic_compare_exchange_n(mutex, &value, tag, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
@@ -253,48 +397,46 @@ namespace skyline::kernel::type {
     void KProcess::ConditionalVariableSignal(u32 *key, i32 amount) {
         TRACE_EVENT_FMT("kernel", "ConditionalVariableSignal 0x{:X}", key);
 
-        std::lock_guard lock(syncWaiterMutex);
-        auto queue{syncWaiters.equal_range(key)};
+        auto &bucket{GetSyncWaiterBucket(key)};
+        std::lock_guard lock(bucket.mutex);
 
-        auto it{queue.first};
-        for (i32 waiterCount{amount}; it != queue.second && (amount <= 0 || waiterCount); it = syncWaiters.erase(it), waiterCount--)
-            state.scheduler->InsertThread(it->second);
+        WakeSyncWaiters(bucket, key, amount);
+        if (CountSyncWaiters(bucket, key))
+            return;
 
-        if (it == queue.second)
-            __atomic_store_n(key, false, __ATOMIC_SEQ_CST); // We need to update the boolean flag denoting that there are no more threads waiting on this conditional variable
+        __atomic_store_n(key, false, __ATOMIC_SEQ_CST); // We need to update the boolean flag denoting that there are no more threads waiting on this conditional variable
     }
 
     Result KProcess::WaitForAddress(u32 *address, u32 value, i64 timeout, bool (*arbitrationFunction)(u32 *, u32)) {
         TRACE_EVENT_FMT("kernel", "WaitForAddress 0x{:X}", address);
 
+        auto &bucket{GetSyncWaiterBucket(address)};
         {
-            std::lock_guard lock(syncWaiterMutex);
+            std::lock_guard lock(bucket.mutex);
             if (!arbitrationFunction(address, value)) [[unlikely]]
                 return result::InvalidState;
 
-            auto queue{syncWaiters.equal_range(address)};
-            syncWaiters.insert(std::upper_bound(queue.first, queue.second, state.thread->priority.load(), [](const i8 priority, const SyncWaiters::value_type &it) { return it.second->priority > priority; }), {address, state.thread});
+            InsertSyncWaiter(bucket, address);
 
             state.scheduler->RemoveThread();
         }
 
         if (timeout > 0 && !state.scheduler->TimedWaitSchedule(std::chrono::nanoseconds(timeout))) {
-            {
-                std::lock_guard lock(syncWaiterMutex);
-                auto queue{syncWaiters.equal_range(address)};
-                auto iterator{std::find(queue.first, queue.second, SyncWaiters::value_type{address, state.thread})};
-                if (iterator != queue.second)
-                    if (syncWaiters.erase(iterator) == queue.second)
-                        __atomic_store_n(address, false, __ATOMIC_SEQ_CST);
-            }
+            std::unique_lock lock(bucket.mutex);
+            if (RemoveSyncWaiter(bucket, address)) {
+                if (!CountSyncWaiters(bucket, address))
+                    __atomic_store_n(address, false, __ATOMIC_SEQ_CST);
 
-            state.scheduler->InsertThread(state.thread);
-            state.scheduler->WaitSchedule();
+                lock.unlock();
+                state.scheduler->InsertThread(state.thread.get());
+                state.scheduler->WaitSchedule();
 
-            return result::TimedOut;
-        } else {
-            state.scheduler->WaitSchedule(false);
+                return result::TimedOut;
+            }
+
+            lock.unlock();
         }
+        state.scheduler->WaitSchedule(false);
 
         return {};
     }
@@ -302,16 +444,16 @@ namespace skyline::kernel::type {
     Result KProcess::SignalToAddress(u32 *address, u32 value, i32 amount, bool(*mutateFunction)(u32 *address, u32 value, u32 waiterCount)) {
         TRACE_EVENT_FMT("kernel", "SignalToAddress 0x{:X}", address);
 
-        std::lock_guard lock(syncWaiterMutex);
-        auto queue{syncWaiters.equal_range(address)};
+        auto &bucket{GetSyncWaiterBucket(address)};
+        std::lock_guard lock(bucket.mutex);
+
+        size_t queueSize{CountSyncWaiters(bucket, address)};
 
         if (mutateFunction)
-            if (!mutateFunction(address, value, (amount <= 0) ? 0 : std::min(static_cast<u32>(std::distance(queue.first, queue.second) - amount), 0U))) [[unlikely]]
+            if (!mutateFunction(address, value, (amount <= 0) ? 0 : std::min(static_cast<u32>(queueSize - amount), 0U))) [[unlikely]]
                 return result::InvalidState;
 
-        i32 waiterCount{amount};
-        for (auto it{queue.first}; it != queue.second && (amount <= 0 || waiterCount); it = syncWaiters.erase(it), waiterCount--)
-            state.scheduler->InsertThread(it->second);
+        WakeSyncWaiters(bucket, address, amount);
 
         return {};
     }
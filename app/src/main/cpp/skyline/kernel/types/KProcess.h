@@ -5,6 +5,7 @@
 
 #include <vfs/npdm.h>
 #include "KThread.h"
+#include "KSharedMemory.h"
 #include "KTransferMemory.h"
 #include "KSession.h"
 #include "KEvent.h"
@@ -14,6 +15,9 @@ namespace skyline {
         constexpr u16 TlsSlotSize{0x200}; //!< The size of a single TLS slot
         constexpr u8 TlsSlots{PAGE_SIZE / TlsSlotSize}; //!< The amount of TLS slots in a single page
         constexpr KHandle BaseHandleIndex{0xD000}; //!< The index of the base handle
+        constexpr size_t MaxHandleCount{0x1000}; //!< The maximum amount of handles that can be open in a process simultaneously
+        constexpr u8 HandleGenerationShift{16}; //!< The offset of the slot generation inside a handle, the bits below it contain the slot index offset by BaseHandleIndex
+        constexpr u16 HandleGenerationMask{0x3FFF}; //!< The mask for the slot generation, handles need to fit in 30 bits as the upper bits are used as flags in mutex values
     }
 
     namespace kernel::type {
@@ -23,15 +27,80 @@ namespace skyline {
         class KProcess : public KSyncObject {
           public: // We have intermittent public/private members to ensure proper construction/destruction order
             MemoryManager memory;
+            ThreadPool threadPool; //!< The pool of host threads that guest threads are run on, this must be destroyed after all threads have exited
 
           private:
             std::mutex threadMutex; //!< Synchronizes thread creation to prevent a race between thread creation and thread killing
             bool disableThreadCreation{}; //!< Whether to disable thread creation, we use this to prevent thread creation after all threads have been killed
             std::vector<std::shared_ptr<KThread>> threads;
 
-            using SyncWaiters = std::multimap<void *, std::shared_ptr<KThread>>;
-            std::mutex syncWaiterMutex; //!< Synchronizes all mutations to the map to prevent races
-            SyncWaiters syncWaiters; //!< All threads waiting on process-wide synchronization primitives (Atomic keys + Address Arbiter)
+            /**
+             * @brief A single shard of the hash table of threads waiting on process-wide synchronization primitives (Atomic keys + Address Arbiter)
+             * @note Each bucket has its own lock, keys that hash into different buckets never contend with each other
+             * @note Every key with waiters has its own intrusive queue sorted by priority, linked through KThread::syncWait*. The first thread of each queue holds its tail and count and links the queues of the bucket together through KThread::syncKey*
+             * @note Waiting never allocates, a key's queue is found by walking the few queues in its bucket after which counting and waking only touch the waiters of that key
+             */
+            struct SyncWaiterBucket {
+                ProfiledMutex mutex{LOCK_SITE("KProcess::SyncWaiterBucket::mutex")}; //!< Synchronizes all mutations to the queues in this bucket and the KThread::sync* members of any threads in them
+                KThread *head{}; //!< The first thread of the first queue in the bucket
+            };
+
+            static constexpr size_t SyncWaiterBucketCount{64}; //!< The amount of buckets in the hash table, this must be a power of 2
+            std::array<SyncWaiterBucket, SyncWaiterBucketCount> syncWaiters;
+
+            /**
+             * @return The bucket in which the queue for the supplied key resides
+             */
+            SyncWaiterBucket &GetSyncWaiterBucket(void *key) {
+                // Keys are word-aligned, so the lower bits are discarded and the rest are mixed with a Fibonacci hash
+                auto hash{(reinterpret_cast<uintptr_t>(key) >> 2) * 0x9E3779B97F4A7C15ULL};
+                return syncWaiters[(hash >> 32) & (SyncWaiterBucketCount - 1)];
+            }
+
+            /**
+             * @return The first thread of the queue for the supplied key, this is null if there are no threads waiting on it
+             * @note 'SyncWaiterBucket::mutex' of the key's bucket **must** be locked by the calling thread prior to calling this
+             */
+            static KThread *FindSyncWaiters(SyncWaiterBucket &bucket, void *key);
+
+            /**
+             * @brief Replaces the first thread of a queue in the bucket, this transfers the tail and count of the queue without adjusting them
+             * @param replacement The new first thread of the queue, the queue is unlinked from the bucket if this is null
+             * @note 'SyncWaiterBucket::mutex' of the bucket **must** be locked by the calling thread prior to calling this
+             */
+            static void ReplaceSyncWaiterHead(SyncWaiterBucket &bucket, KThread *head, KThread *replacement);
+
+            /**
+             * @brief Inserts the calling thread into the queue for the supplied key according to its priority
+             * @note 'SyncWaiterBucket::mutex' of the key's bucket **must** be locked by the calling thread prior to calling this
+             */
+            void InsertSyncWaiter(SyncWaiterBucket &bucket, void *key);
+
+            /**
+             * @brief Removes the calling thread from the queue for the supplied key, if it's still in it
+             * @return If the thread was still in the queue, this is false if it's already been removed by a signal
+             * @note 'SyncWaiterBucket::mutex' of the key's bucket **must** be locked by the calling thread prior to calling this
+             */
+            bool RemoveSyncWaiter(SyncWaiterBucket &bucket, void *key);
+
+            /**
+             * @brief Unlinks the supplied thread from the queue it's in, this is O(1) for the first thread of a queue
+             * @note 'SyncWaiterBucket::mutex' of the bucket **must** be locked by the calling thread prior to calling this
+             */
+            static void UnlinkSyncWaiter(SyncWaiterBucket &bucket, KThread *thread);
+
+            /**
+             * @return The amount of threads waiting on the supplied key
+             * @note 'SyncWaiterBucket::mutex' of the key's bucket **must** be locked by the calling thread prior to calling this
+             */
+            static size_t CountSyncWaiters(SyncWaiterBucket &bucket, void *key);
+
+            /**
+             * @brief Wakes up the highest priority threads waiting on the supplied key
+             * @param amount The amount of threads to wake up, a value of 0 or below wakes up all of them
+             * @note 'SyncWaiterBucket::mutex' of the key's bucket **must** be locked by the calling thread prior to calling this
+             */
+            void WakeSyncWaiters(SyncWaiterBucket &bucket, void *key, i32 amount);
 
             /**
             * @brief The status of a single TLS page (A page is 4096 bytes on ARMv8)
@@ -61,8 +130,79 @@ namespace skyline {
             vfs::NPDM npdm;
 
           private:
-            std::shared_mutex handleMutex;
-            std::vector<std::shared_ptr<KObject>> handles;
+            /**
+             * @brief A single slot in the handle table, slots are reused after being closed and their generation is bumped on every reuse to detect stale handles
+             */
+            struct HandleSlot {
+                std::atomic<KHandle> handle{}; //!< The handle which is currently valid for this slot or 0 if it's free, this is published after the object and cleared prior to it
+                std::atomic<u32> readers{}; //!< The amount of lookups which might be copying 'object', it's only reset after the handle has been cleared and this has dropped to 0
+                std::shared_ptr<KObject> object; //!< The object in this slot, this is only written with 'handleMutex' locked while the slot has no valid handle and no readers
+                u16 generation{}; //!< The generation of the slot, this is only accessed with 'handleMutex' locked
+            };
+
+            ProfiledMutex handleMutex{LOCK_SITE("KProcess::handleMutex")}; //!< Synchronizes all mutations of the handle table, lookups are lock-free and don't require this to be locked
+            std::array<HandleSlot, constant::MaxHandleCount> handleSlots;
+            std::atomic<size_t> handleSlotsUsed{}; //!< The amount of slots at the start of the table that have ever been used, any slots beyond this are guaranteed to be free
+            std::vector<u16> freeHandleSlots; //!< The indices of all slots below 'handleSlotsUsed' which are currently free
+
+            /**
+             * @brief Reserves a free slot in the handle table and computes the handle that will refer to it
+             * @return The index of the reserved slot and its handle, the handle will only be valid after it has been published with PublishHandle
+             * @note 'handleMutex' **must** be locked by the calling thread prior to calling this
+             */
+            std::pair<size_t, KHandle> ReserveHandleSlot() {
+                size_t index;
+                if (!freeHandleSlots.empty()) {
+                    index = freeHandleSlots.back();
+                    freeHandleSlots.pop_back();
+                } else if (handleSlotsUsed < constant::MaxHandleCount) {
+                    index = handleSlotsUsed;
+                } else {
+                    throw exception("Process has run out of handles: {} are currently open", constant::MaxHandleCount);
+                }
+
+                return {index, static_cast<KHandle>((constant::BaseHandleIndex + index) | (static_cast<KHandle>(handleSlots[index].generation) << constant::HandleGenerationShift))};
+            }
+
+            /**
+             * @brief Returns a slot reserved by ReserveHandleSlot that won't be published, this is used when constructing the object failed
+             * @note 'handleMutex' **must** be locked by the calling thread prior to calling this
+             */
+            void ReleaseHandleSlot(size_t index) {
+                if (index < handleSlotsUsed)
+                    freeHandleSlots.push_back(static_cast<u16>(index)); // Slots at the end of the table were never taken from the free list
+            }
+
+            /**
+             * @brief Makes the object in a reserved slot visible to lookups
+             * @note 'handleMutex' **must** be locked by the calling thread prior to calling this
+             */
+            void PublishHandle(size_t index, KHandle handle, std::shared_ptr<KObject> object) {
+                auto &slot{handleSlots[index]};
+                slot.object = std::move(object); // Lookups only read the object after observing the handle which is stored after this
+                slot.handle.store(handle, std::memory_order_release);
+                if (index == handleSlotsUsed)
+                    handleSlotsUsed.store(index + 1, std::memory_order_release);
+            }
+
+            /**
+             * @brief Looks up the object referred to by a handle without locking the handle table
+             * @return The object or nullptr if the handle is invalid or stale
+             * @note The slot's reader count is raised before the handle is checked, CloseHandle waits for it to drop after clearing the handle so the object can't be reset while it's being copied
+             */
+            std::shared_ptr<KObject> LookupHandle(KHandle handle) {
+                size_t index{(handle & ((1U << constant::HandleGenerationShift) - 1)) - constant::BaseHandleIndex};
+                if (index >= constant::MaxHandleCount) [[unlikely]]
+                    return nullptr;
+
+                auto &slot{handleSlots[index]};
+                slot.readers.fetch_add(1, std::memory_order_seq_cst); // This must be sequentially consistent with the handle being cleared and the reader count being checked in CloseHandle
+                std::shared_ptr<KObject> object;
+                if (slot.handle.load(std::memory_order_seq_cst) == handle) [[likely]]
+                    object = slot.object;
+                slot.readers.fetch_sub(1, std::memory_order_release);
+                return object;
+            }
 
           public:
             KProcess(const DeviceState &state);
@@ -115,13 +255,19 @@ namespace skyline {
             HandleOut<objectClass> NewHandle(objectArgs... args) {
                 std::unique_lock lock(handleMutex);
 
+                auto[index, handle]{ReserveHandleSlot()};
                 std::shared_ptr<objectClass> item;
-                if constexpr (std::is_same<objectClass, KThread>())
-                    item = std::make_shared<objectClass>(state, constant::BaseHandleIndex + handles.size(), args...);
-                else
-                    item = std::make_shared<objectClass>(state, args...);
-                handles.push_back(std::static_pointer_cast<KObject>(item));
-                return {item, static_cast<KHandle>((constant::BaseHandleIndex + handles.size()) - 1)};
+                try {
+                    if constexpr (std::is_same<objectClass, KThread>())
+                        item = std::make_shared<objectClass>(state, handle, args...);
+                    else
+                        item = std::make_shared<objectClass>(state, args...);
+                } catch (...) {
+                    ReleaseHandleSlot(index);
+                    throw;
+                }
+                PublishHandle(index, handle, std::static_pointer_cast<KObject>(item));
+                return {item, handle};
             }
 
             /**
@@ -132,14 +278,13 @@ namespace skyline {
             KHandle InsertItem(std::shared_ptr<objectClass> &item) {
                 std::unique_lock lock(handleMutex);
 
-                handles.push_back(std::static_pointer_cast<KObject>(item));
-                return static_cast<KHandle>((constant::BaseHandleIndex + handles.size()) - 1);
+                auto[index, handle]{ReserveHandleSlot()};
+                PublishHandle(index, handle, std::static_pointer_cast<KObject>(item));
+                return handle;
             }
 
             template<typename objectClass = KObject>
             std::shared_ptr<objectClass> GetHandle(KHandle handle) {
-                std::shared_lock lock(handleMutex);
-
                 KType objectType;
                 if constexpr(std::is_same<objectClass, KThread>()) {
                     constexpr KHandle threadSelf{0xFFFF8000}; // The handle used by threads to refer to themselves
@@ -164,27 +309,22 @@ namespace skyline {
                 } else {
                     throw exception("KProcess::GetHandle couldn't determine object type");
                 }
-                try {
-                    auto &item{handles.at(handle - constant::BaseHandleIndex)};
-                    if (item != nullptr && item->objectType == objectType)
-                        return std::static_pointer_cast<objectClass>(item);
-                    else if (item == nullptr)
-                        throw exception("GetHandle was called with a deleted handle: 0x{:X}", handle);
-                    else
-                        throw exception("Tried to get kernel object (0x{:X}) with different type: {} when object is {}", handle, objectType, item->objectType);
-                } catch (const std::out_of_range &) {
-                    throw std::out_of_range(fmt::format("GetHandle was called with an invalid handle: 0x{:X}", handle));
-                }
+
+                auto item{LookupHandle(handle)};
+                if (item == nullptr) [[unlikely]]
+                    throw std::out_of_range(fmt::format("GetHandle was called with an invalid or closed handle: 0x{:X}", handle));
+                else if (item->objectType != objectType) [[unlikely]]
+                    throw exception("Tried to get kernel object (0x{:X}) with different type: {} when object is {}", handle, objectType, item->objectType);
+                return std::static_pointer_cast<objectClass>(item);
             }
 
             template<>
             std::shared_ptr<KObject> GetHandle<KObject>(KHandle handle) {
-                std::shared_lock lock(handleMutex);
-                auto &item{handles.at(handle - constant::BaseHandleIndex)};
-                if (item != nullptr)
+                auto item{LookupHandle(handle)};
+                if (item != nullptr) [[likely]]
                     return item;
                 else
-                    throw std::out_of_range(fmt::format("GetHandle was called with a deleted handle: 0x{:X}", handle));
+                    throw std::out_of_range(fmt::format("GetHandle was called with an invalid or closed handle: 0x{:X}", handle));
             }
 
             /**
@@ -195,11 +335,10 @@ namespace skyline {
             std::optional<HandleOut<KMemory>> GetMemoryObject(u8 *ptr);
 
             /**
-             * @brief Closes a handle in the handle table
+             * @brief Closes a handle in the handle table, the slot it occupied will be reused by subsequently created handles
+             * @note This will throw std::out_of_range if the handle is invalid or has already been closed
              */
-            void CloseHandle(KHandle handle) {
-                handles.at(handle - constant::BaseHandleIndex) = nullptr;
-            }
+            void CloseHandle(KHandle handle);
 
             /**
              * @brief Locks the mutex at the specified address
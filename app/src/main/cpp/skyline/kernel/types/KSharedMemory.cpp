@@ -18,6 +18,7 @@ namespace skyline::kernel::type {
             throw exception("An occurred while mapping shared memory: {}", strerror(errno));
 
         host.size = size;
+        hostAllocation.Resize(size);
     }
 
     u8 *KSharedMemory::Map(u8 *ptr, u64 size, memory::Permission permission) {
@@ -51,8 +52,7 @@ namespace skyline::kernel::type {
         if (guest.ptr != ptr && guest.size != size)
             throw exception("Unmapping KSharedMemory partially is not supported: Requested Unmap: 0x{:X} - 0x{:X} (0x{:X}), Current Mapping: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size, guest.ptr, guest.ptr + guest.size, guest.size);
 
-        if (mmap(ptr, size, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED, 0, 0) == MAP_FAILED)
-            throw exception("An error occurred while unmapping shared memory in guest: {}", strerror(errno));
+        state.process->memory.RestoreBacking(ptr, size);
 
         guest = {};
         state.process->memory.InsertChunk(ChunkDescriptor{
@@ -85,7 +85,8 @@ namespace skyline::kernel::type {
             munmap(host.ptr, host.size);
 
         if (state.process && guest.Valid()) {
-            mmap(guest.ptr, guest.size, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0); // As this is the destructor, we cannot throw on this failing
+            auto &memory{state.process->memory};
+            mmap(guest.ptr, guest.size, PROT_NONE, MAP_SHARED | MAP_FIXED, memory.memoryFd, reinterpret_cast<u64>(guest.ptr) - memory.base.address); // As this is the destructor, we cannot throw on this failing
             state.process->memory.InsertChunk(ChunkDescriptor{
                 .ptr = guest.ptr,
                 .size = guest.size,
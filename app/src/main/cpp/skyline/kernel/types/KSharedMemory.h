@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <common/memory_accounting.h>
 #include "KMemory.h"
 
 namespace skyline::kernel::type {
@@ -23,6 +24,7 @@ namespace skyline::kernel::type {
                 return ptr && size;
             }
         } host, guest{}; //!< We keep two mirrors of the underlying shared memory for guest access and host access, the host mirror is persistently mapped and should be used by anything accessing the memory on the host
+        accounting::Allocation hostAllocation{accounting::Category::GuestShared}; //!< The attribution of the host mirror, this can be moved to a more specific category by the owner of the memory
 
         KSharedMemory(const DeviceState &state, size_t size, memory::MemoryState memState = memory::states::SharedMemory, KType type = KType::KSharedMemory);
 
@@ -9,8 +9,8 @@ namespace skyline::kernel::type {
         std::lock_guard lock(syncObjectMutex);
         signalled = true;
         for (auto &waiter : syncObjectWaiters) {
-            if (waiter->isCancellable) {
-                waiter->isCancellable = false;
+            if (waiter->isCancellable.exchange(false)) {
+                // We need to ensure that only one of the objects (or a cancellation) that the thread is waiting on can wake it up
                 waiter->wakeObject = this;
                 state.scheduler->InsertThread(waiter);
             }
@@ -18,11 +18,6 @@ namespace skyline::kernel::type {
     }
 
     bool KSyncObject::ResetSignal() {
-        std::lock_guard lock(syncObjectMutex);
-        if (signalled) [[likely]] {
-            signalled = false;
-            return true;
-        }
-        return false;
+        return signalled.exchange(false);
     }
 }
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <common/lock_profiler.h>
 #include "KObject.h"
 
 namespace skyline::kernel::type {
@@ -12,9 +13,9 @@ namespace skyline::kernel::type {
      */
     class KSyncObject : public KObject {
       public:
-        inline static std::mutex syncObjectMutex; //!< A global lock used for locking all signalling to avoid races
-        std::list<std::shared_ptr<KThread>> syncObjectWaiters; //!< A list of threads waiting on this object to be signalled
-        bool signalled; //!< If the current object is signalled (An object stays signalled till the signal has been explicitly reset)
+        ProfiledMutex syncObjectMutex{LOCK_SITE("KSyncObject::syncObjectMutex")}; //!< Synchronizes all signalling and mutations of the waiter list of this object, it must be locked in ascending order of object address when locking multiple objects
+        std::list<KThread *> syncObjectWaiters; //!< A list of threads waiting on this object to be signalled, these are borrowed as a waiting thread always removes itself prior to returning
+        std::atomic<bool> signalled; //!< If the current object is signalled (An object stays signalled till the signal has been explicitly reset), this can be read without locking 'syncObjectMutex'
 
         /**
          * @param presignalled If this object should be signalled initially or not
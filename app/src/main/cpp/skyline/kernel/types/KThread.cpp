@@ -6,6 +6,7 @@
 #include <common/signal.h>
 #include <common/trace.h>
 #include <nce.h>
+#include <kernel/profiler.h>
 #include <os.h>
 #include "KProcess.h"
 #include "KThread.h"
@@ -17,13 +18,12 @@ namespace skyline::kernel::type {
 
     KThread::~KThread() {
         Kill(true);
-        if (thread.joinable())
-            thread.join();
         if (preemptionTimer)
             timer_delete(preemptionTimer);
     }
 
     void KThread::StartThread() {
+        pthread = pthread_self();
         std::array<char, 16> threadName;
         pthread_getname_np(pthread, threadName.data(), threadName.size());
         pthread_setname_np(pthread, fmt::format("HOS-{}", id).c_str());
@@ -33,10 +33,14 @@ namespace skyline::kernel::type {
             ctx.tpidrroEl0 = parent->AllocateTlsSlot();
 
         ctx.state = &state;
+        ctx.threadId = id;
+        ctx.coreId = &coreId;
+        ctx.priority = reinterpret_cast<const u8 *>(&priority);
         state.ctx = &ctx;
         state.thread = shared_from_this();
 
         if (setjmp(originalCtx)) { // Returns 1 if it's returning from guest, 0 otherwise
+            state.profiler->StopThread();
             state.scheduler->RemoveThread();
 
             {
@@ -56,16 +60,22 @@ namespace skyline::kernel::type {
             return;
         }
 
-        struct sigevent event{
-            .sigev_signo = Scheduler::PreemptionSignal,
-            .sigev_notify = SIGEV_THREAD_ID,
-            .sigev_notify_thread_id = gettid(),
-        };
-        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &preemptionTimer))
-            throw exception("timer_create has failed with '{}'", strerror(errno));
+        if (!preemptionTimer) {
+            // Pooled host threads lend their own preemption timer and have their signal handlers installed once, we only need to do this if we're running on any other host thread
+            struct sigevent event{
+                .sigev_signo = Scheduler::PreemptionSignal,
+                .sigev_notify = SIGEV_THREAD_ID,
+                .sigev_notify_thread_id = gettid(),
+            };
+            if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &preemptionTimer))
+                throw exception("timer_create has failed with '{}'", strerror(errno));
 
-        signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, nce::NCE::SignalHandler);
-        signal::SetSignalHandler({Scheduler::YieldSignal, Scheduler::PreemptionSignal}, Scheduler::SignalHandler, false); // We want futexes to fail and their predicates rechecked
+            signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, nce::NCE::SignalHandler);
+            signal::SetSignalHandler({Scheduler::YieldSignal, Scheduler::PreemptionSignal}, Scheduler::SignalHandler, false); // We want futexes to fail and their predicates rechecked
+            signal::SetSignalHandler({Profiler::ProfilerSignal}, Profiler::SignalHandler);
+        }
+
+        state.profiler->StartThread(stackTop);
 
         {
             std::lock_guard lock(statusMutex);
@@ -190,21 +200,18 @@ namespace skyline::kernel::type {
         if (!running) {
             {
                 std::lock_guard migrationLock(coreMigrationMutex);
-                auto thisShared{shared_from_this()};
-                coreId = state.scheduler->GetOptimalCoreForThread(thisShared).id;
-                state.scheduler->InsertThread(thisShared);
+                coreId = state.scheduler->GetOptimalCoreForThread(this).id;
+                state.scheduler->InsertThread(this);
             }
 
             running = true;
             killed = false;
             statusCondition.notify_all();
             if (self) {
-                pthread = pthread_self();
                 lock.unlock();
                 StartThread();
             } else {
-                thread = std::thread(&KThread::StartThread, this);
-                pthread = thread.native_handle();
+                parent->threadPool.Attach(this);
             }
         }
     }
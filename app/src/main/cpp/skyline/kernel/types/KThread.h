@@ -6,6 +6,7 @@
 #include <csetjmp>
 #include <nce/guest.h>
 #include <kernel/scheduler.h>
+#include <kernel/thread_pool.h>
 #include <common/signal.h>
 #include "KSyncObject.h"
 #include "KPrivateMemory.h"
@@ -19,13 +20,14 @@ namespace skyline {
         class KThread : public KSyncObject, public std::enable_shared_from_this<KThread> {
           private:
             KProcess *parent;
-            std::thread thread; //!< If this KThread is backed by a host thread then this'll hold it
             pthread_t pthread{}; //!< The pthread_t for the host thread running this guest thread
-            timer_t preemptionTimer{}; //!< A kernel timer used for preemption interrupts
+            timer_t preemptionTimer{}; //!< A kernel timer used for preemption interrupts, this is lent by the host thread when running on a pooled host thread
+
+            friend ThreadPool;
 
             /**
              * @brief Entry function any guest threads, sets up necessary context and jumps into guest code from the calling thread
-             * @note This function also serves as the entry point for host threads created in StartThread
+             * @note This function also serves as the entry point for guest threads attached to a host thread from the ThreadPool
              */
             void StartThread();
 
@@ -46,7 +48,7 @@ namespace skyline {
             u64 entryArgument; //!< An argument to provide with to the thread entry function
             void *stackTop; //!< The top of the guest's stack, this is set to the initial guest stack pointer
 
-            std::condition_variable scheduleCondition; //!< Signalled to wake the thread when it's scheduled or its resident core changes
+            ProfiledConditionVariable scheduleCondition; //!< Signalled to wake the thread when it's scheduled or its resident core changes
             std::atomic<u8> basePriority; //!< The priority of the thread for the scheduler without any priority-inheritance
             std::atomic<u8> priority; //!< The priority of the thread for the scheduler including priority-inheritance
 
@@ -65,19 +67,27 @@ namespace skyline {
             std::mutex waiterMutex; //!< Synchronizes operations on mutation of the waiter members
             u32 *waitKey; //!< The key of the mutex which this thread is waiting on
             KHandle waitTag; //!< The handle of the thread which requested the mutex lock
-            std::shared_ptr<KThread> waitThread; //!< The thread which this thread is waiting on
-            std::list<std::shared_ptr<type::KThread>> waiters; //!< A queue of threads waiting on this thread sorted by priority
+            KThread *waitThread{}; //!< The thread which this thread is waiting on
+            std::list<type::KThread *> waiters; //!< A queue of threads waiting on this thread sorted by priority
+
+            void *syncWaitKey{}; //!< The key of the process-wide synchronization primitive this thread is waiting on, this is null when the thread isn't in any KProcess sync waiter queue
+            KThread *syncWaitPrevious{}; //!< The previous thread in the intrusive KProcess sync waiter queue of the key this thread is waiting on
+            KThread *syncWaitNext{}; //!< The next thread in the intrusive KProcess sync waiter queue of the key this thread is waiting on
+            KThread *syncWaitTail{}; //!< The last thread in the sync waiter queue, this is only valid on the first thread of a queue
+            size_t syncWaitCount{}; //!< The amount of threads in the sync waiter queue, this is only valid on the first thread of a queue
+            KThread *syncKeyPrevious{}; //!< The first thread of the previous queue in the KProcess sync waiter bucket, this is only valid on the first thread of a queue
+            KThread *syncKeyNext{}; //!< The first thread of the next queue in the KProcess sync waiter bucket, this is only valid on the first thread of a queue
 
-            bool isCancellable{false}; //!< If the thread is currently in a position where it's cancellable
-            bool cancelSync{false}; //!< Whether to cancel the SvcWaitSynchronization call this thread currently is in/the next one it joins
-            type::KSyncObject *wakeObject{}; //!< A pointer to the synchronization object responsible for waking this thread up
+            std::atomic<bool> isCancellable{false}; //!< If the thread is currently in a position where it's cancellable, whoever exchanges this from true to false is responsible for waking the thread up
+            std::atomic<bool> cancelSync{false}; //!< Whether to cancel the SvcWaitSynchronization call this thread currently is in/the next one it joins
+            type::KSyncObject *wakeObject{}; //!< A pointer to the synchronization object responsible for waking this thread up, this is written prior to the thread being inserted into the scheduler
 
             KThread(const DeviceState &state, KHandle handle, KProcess *parent, size_t id, void *entry, u64 argument, void *stackTop, u8 priority, i8 idealCore);
 
             ~KThread();
 
             /**
-             * @param self If the calling thread should jump directly into guest code or if a new thread should be created for it
+             * @param self If the calling thread should jump directly into guest code or if the thread should be attached to a pooled host thread
              * @note If the thread is already running then this does nothing
              * @note 'stack' will be created if it wasn't set prior to calling this
              */
@@ -112,7 +122,7 @@ namespace skyline {
             /**
              * @return If the supplied priority value is higher than the supplied thread's priority value
              */
-            static constexpr bool IsHigherPriority(const i8 priority, const std::shared_ptr<type::KThread> &it) {
+            static constexpr bool IsHigherPriority(const i8 priority, const type::KThread *it) {
                 return priority < it->priority;
             }
         };
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "KTransferMemory.h"
+#include "KProcess.h"
+
+namespace skyline::kernel::type {
+    KTransferMemory::KTransferMemory(const DeviceState &state, u8 *ptr, size_t size, memory::Permission permission, memory::MemoryState memState) : memoryState(memState), KMemory(state, KType::KTransferMemory) {
+        auto &memory{state.process->memory};
+        if (!memory.base.IsInside(ptr) || !memory.base.IsInside(ptr + size - 1))
+            throw exception("KTransferMemory allocation isn't inside guest address space: 0x{:X} - 0x{:X}", ptr, ptr + size);
+        if (!util::PageAligned(ptr) || !util::PageAligned(size))
+            throw exception("KTransferMemory mapping isn't page-aligned: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size);
+
+        // The range may span several chunks with differing permissions or states, all of them are saved clipped to the range so they can be restored individually
+        auto end{ptr + size};
+        for (auto chunkPtr{ptr}; chunkPtr < end;) {
+            auto chunk{memory.Get(chunkPtr)};
+            if (!chunk)
+                throw exception("KTransferMemory created from memory without a descriptor: 0x{:X} - 0x{:X}", chunkPtr, end);
+
+            auto chunkEnd{std::min(chunk->ptr + chunk->size, end)};
+            chunk->ptr = chunkPtr;
+            chunk->size = static_cast<size_t>(chunkEnd - chunkPtr);
+            originalChunks.push_back(*chunk);
+            chunkPtr = chunkEnd;
+        }
+
+        guest = span(ptr, size);
+
+        memory.InsertChunk(ChunkDescriptor{
+            .ptr = ptr,
+            .size = size,
+            .permission = permission,
+            .state = memoryState,
+        });
+    }
+
+    void KTransferMemory::UpdatePermission(u8 *ptr, size_t size, memory::Permission permission) {
+        if (ptr && !util::PageAligned(ptr))
+            throw exception("KTransferMemory permission updated with a non-page-aligned address: 0x{:X}", ptr);
+
+        state.process->memory.InsertChunk(ChunkDescriptor{
+            .ptr = ptr,
+            .size = size,
+            .permission = permission,
+            .state = memoryState,
+        });
+    }
+
+    KTransferMemory::~KTransferMemory() {
+        if (state.process)
+            for (const auto &chunk : originalChunks)
+                state.process->memory.InsertChunk(chunk);
+    }
+}
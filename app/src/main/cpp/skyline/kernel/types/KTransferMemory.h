@@ -3,20 +3,35 @@
 
 #pragma once
 
-#include "KSharedMemory.h"
+#include "KMemory.h"
 
 namespace skyline::kernel::type {
     /**
-     * @brief KTransferMemory is used to transfer memory from one application to another on HOS, we emulate this abstraction using KSharedMemory as it's essentially the same with the main difference being that KSharedMemory is allocated by the kernel while KTransferMemory is created from memory that's been allocated by the guest beforehand
+     * @brief KTransferMemory is used to transfer memory from one application to another on HOS, it's created from memory that's been allocated by the guest beforehand
+     * @note The transferred guest memory is accessed in place by the host as it's mapped into the host address space, it's never copied in or out
      */
-    class KTransferMemory : public KSharedMemory {
+    class KTransferMemory : public KMemory {
+      private:
+        memory::MemoryState memoryState; //!< The state of the memory as supplied initially, this is retained for any permission updates
+        std::vector<ChunkDescriptor> originalChunks; //!< The chunks covering the guest memory prior to it being transferred, they're restored on destruction
+
       public:
+        span<u8> guest; //!< The guest memory which was transferred
+
         /**
          * @note 'ptr' needs to be in guest-reserved address space
          */
-        KTransferMemory(const DeviceState &state, u8 *ptr, size_t size, memory::Permission permission, memory::MemoryState memState = memory::states::TransferMemory) : KSharedMemory(state, size, memState, KType::KTransferMemory) {
-            std::memcpy(host.ptr, ptr, size);
-            Map(ptr, size, permission);
+        KTransferMemory(const DeviceState &state, u8 *ptr, size_t size, memory::Permission permission, memory::MemoryState memState = memory::states::TransferMemory);
+
+        span<u8> Get() override {
+            return guest;
         }
+
+        void UpdatePermission(u8 *ptr, size_t size, memory::Permission permission) override;
+
+        /**
+         * @brief The destructor of transfer memory, it returns the guest memory to its prior state
+         */
+        ~KTransferMemory();
     };
 }
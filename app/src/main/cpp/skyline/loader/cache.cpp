@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/stat.h>
+#include <dlfcn.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <unistd.h>
+#include <mbedtls/sha256.h>
+#include <os.h>
+#include "cache.h"
+
+namespace skyline::loader {
+    /**
+     * @return The GNU build ID of libskyline zero-padded to 32 bytes, or std::nullopt if it wasn't linked with one
+     */
+    static std::optional<std::array<u8, 0x20>> GetHostBuildId() {
+        Dl_info info{};
+        if (!dladdr(reinterpret_cast<void *>(&GetHostBuildId), &info))
+            return std::nullopt;
+
+        struct Search {
+            void *base; //!< The load address of libskyline
+            std::optional<std::array<u8, 0x20>> buildId;
+        } search{info.dli_fbase};
+
+        dl_iterate_phdr([](dl_phdr_info *object, size_t, void *data) -> int {
+            auto &search{*reinterpret_cast<Search *>(data)};
+            if (reinterpret_cast<void *>(object->dlpi_addr) != search.base)
+                return 0; // This isn't libskyline, its first segment is at a virtual address of 0 so its load bias is equal to its base
+
+            for (ElfW(Half) index{}; index < object->dlpi_phnum; index++) {
+                auto &header{object->dlpi_phdr[index]};
+                if (header.p_type != PT_NOTE)
+                    continue;
+
+                auto note{reinterpret_cast<u8 *>(object->dlpi_addr + header.p_vaddr)}, noteEnd{note + header.p_memsz};
+                while (note + sizeof(ElfW(Nhdr)) <= noteEnd) {
+                    auto &noteHeader{*reinterpret_cast<ElfW(Nhdr) *>(note)};
+                    auto name{note + sizeof(ElfW(Nhdr))};
+                    auto descriptor{name + util::AlignUp(noteHeader.n_namesz, 4)};
+                    if (noteHeader.n_type == NT_GNU_BUILD_ID && noteHeader.n_namesz == 4 && std::memcmp(name, "GNU", 4) == 0 && noteHeader.n_descsz <= 0x20) {
+                        std::array<u8, 0x20> buildId{};
+                        std::memcpy(buildId.data(), descriptor, noteHeader.n_descsz);
+                        search.buildId = buildId;
+                        return 1;
+                    }
+                    note = descriptor + util::AlignUp(noteHeader.n_descsz, 4);
+                }
+            }
+            return 0;
+        }, &search);
+
+        return search.buildId;
+    }
+
+    PatchCache::PatchCache(const DeviceState &state, const Executable::Identifier &identifier) : state(state) {
+        static const auto hostBuildId{GetHostBuildId()}; // This is constant for the lifetime of the process
+        if (!hostBuildId) {
+            state.logger->Warn("libskyline has no build ID, the patch cache is disabled");
+            return;
+        }
+
+        key.identifier = identifier;
+        asm("MRS %0, CNTFRQ_EL0" : "=r"(key.frequency));
+        key.hostBuildId = *hostBuildId;
+
+        path = state.os->appFilesPath + "/cache/";
+        mkdir(path.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+        path += "nce/";
+        mkdir(path.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+
+        for (u8 byte : span(identifier.buildId).cast<const u8>())
+            path += fmt::format("{:02X}", byte);
+        path += ".bin";
+
+        int fd{open(path.c_str(), O_RDONLY)};
+        if (fd < 0)
+            return;
+
+        Header header{};
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) || pread64(fd, &header, sizeof(Header), 0) != sizeof(Header) || header.magic != util::MakeMagic<u32>("SPC0") || header.version != Version || header.key != key || static_cast<size_t>(fileInfo.st_size) != DataOffset + header.patchSize + header.textSize) {
+            state.logger->Debug("Ignoring stale patch cache entry: {}", path);
+            close(fd);
+            return;
+        }
+
+        auto size{static_cast<size_t>(fileInfo.st_size)};
+        auto ptr{reinterpret_cast<u8 *>(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0))};
+        close(fd);
+        if (ptr == MAP_FAILED) {
+            state.logger->Warn("Failed to map patch cache entry '{}': {}", path, strerror(errno));
+            return;
+        }
+
+        std::array<u8, 0x20> hash{};
+        if (mbedtls_sha256(ptr + DataOffset, size - DataOffset, hash.data(), 0) != 0 || hash != header.hash) {
+            state.logger->Warn("Patch cache entry '{}' is corrupted, it'll be regenerated", path);
+            munmap(ptr, size);
+            return;
+        }
+
+        mapping = span<u8>(ptr, size);
+        patch = mapping.subspan(DataOffset, header.patchSize);
+        text = mapping.subspan(DataOffset + header.patchSize, header.textSize);
+    }
+
+    PatchCache::~PatchCache() {
+        if (Valid())
+            munmap(mapping.data(), mapping.size());
+    }
+
+    void PatchCache::Store(span<u8> patchSection, span<u8> textSection) {
+        if (path.empty())
+            return;
+
+        Header header{
+            .magic = util::MakeMagic<u32>("SPC0"),
+            .version = Version,
+            .key = key,
+            .patchSize = patchSection.size(),
+            .textSize = textSection.size(),
+        };
+
+        mbedtls_sha256_context context;
+        mbedtls_sha256_init(&context);
+        bool hashed{mbedtls_sha256_starts(&context, 0) == 0 && mbedtls_sha256_update(&context, patchSection.data(), patchSection.size()) == 0 && mbedtls_sha256_update(&context, textSection.data(), textSection.size()) == 0 && mbedtls_sha256_finish(&context, header.hash.data()) == 0};
+        mbedtls_sha256_free(&context);
+        if (!hashed) {
+            state.logger->Warn("Failed to hash patch cache entry: {}", path);
+            return;
+        }
+
+        // The entry is written to a temporary file which replaces the entry atomically, this prevents a partially written entry from being read
+        auto temporaryPath{path + ".tmp"};
+        int fd{open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR)};
+        if (fd < 0) {
+            state.logger->Warn("Failed to create patch cache entry '{}': {}", temporaryPath, strerror(errno));
+            return;
+        }
+
+        bool written{pwrite64(fd, &header, sizeof(Header), 0) == sizeof(Header) &&
+            pwrite64(fd, patchSection.data(), patchSection.size(), DataOffset) == static_cast<ssize_t>(patchSection.size()) &&
+            pwrite64(fd, textSection.data(), textSection.size(), DataOffset + patchSection.size()) == static_cast<ssize_t>(textSection.size())};
+        close(fd);
+
+        if (!written || rename(temporaryPath.c_str(), path.c_str())) {
+            state.logger->Warn("Failed to write patch cache entry '{}': {}", path, strerror(errno));
+            unlink(temporaryPath.c_str());
+        }
+    }
+}
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+#include "executable.h"
+
+namespace skyline::loader {
+    /**
+     * @brief A persistent on-disk cache of the .patch and patched .text sections of executables, this avoids scanning and patching the code of an executable every time it's loaded
+     * @note The main SVC trampoline isn't usable from the cache as it contains host addresses, it needs to be written by NCE::PatchCode after loading
+     * @note Entries are keyed on the build ID of libskyline, the cache is disabled if it doesn't have one as there'd be no way to tell if an entry was generated by different code
+     */
+    class PatchCache {
+      private:
+        constexpr static u32 Version{2}; //!< The version of the cache format, changes to the code generated by NCE::PatchCode are covered by the host build ID in the key instead
+
+        struct Key {
+            Executable::Identifier identifier; //!< The identifier of the executable
+            u64 frequency; //!< The value of CNTFRQ_EL0, this determines if the host clock is rescaled in the trampolines
+            std::array<u8, 0x20> hostBuildId; //!< The GNU build ID of libskyline padded with zeroes, any change to the trampoline generator or the host structures it depends on changes this
+
+            bool operator==(const Key &) const = default;
+        };
+
+        struct Header {
+            u32 magic; //!< The magic "SPC0"
+            u32 version; //!< The version of the cache format
+            Key key; //!< The key of the entry, this must match the executable being loaded
+            u64 patchSize; //!< The size of the .patch section
+            u64 textSize; //!< The size of the .text section
+            std::array<u8, 0x20> hash; //!< The SHA256 checksum of the .patch and .text sections
+        };
+        static_assert(sizeof(Header) <= PAGE_SIZE);
+
+        constexpr static size_t DataOffset{PAGE_SIZE}; //!< The offset of the sections in the cache file, they're page-aligned so they can be mapped directly
+
+        const DeviceState &state;
+        std::string path; //!< The path to the cache file of the executable, this is empty if the cache is unusable
+        Key key;
+        span<u8> mapping; //!< A read-only mapping of the entire cache file, this is only valid if the entry was found and verified
+
+      public:
+        span<u8> patch; //!< The cached .patch section, this is only valid if the entry was found and verified
+        span<u8> text; //!< The cached patched .text section, this is only valid if the entry was found and verified
+
+        /**
+         * @brief Looks up the cache entry for the supplied executable, it's mapped and verified if it exists
+         */
+        PatchCache(const DeviceState &state, const Executable::Identifier &identifier);
+
+        ~PatchCache();
+
+        /**
+         * @return If a valid cache entry was found for the executable
+         */
+        bool Valid() {
+            return !mapping.empty();
+        }
+
+        /**
+         * @brief Writes the patched sections of the executable to the cache, any failures are logged rather than thrown as the cache is optional
+         */
+        void Store(span<u8> patchSection, span<u8> textSection);
+    };
+}
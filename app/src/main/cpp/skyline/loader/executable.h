@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include <common.h>
+#include <common/memory_accounting.h>
 
 namespace skyline::loader {
     /**
@@ -30,5 +30,19 @@ namespace skyline::loader {
 
         RelativeSegment dynsym; //!< The .dynsym segment relative to .rodata
         RelativeSegment dynstr; //!< The .dynstr segment relative to .rodata
+
+        /**
+         * @brief A unique identifier for the contents of an executable
+         */
+        struct Identifier {
+            std::array<u64, 4> buildId; //!< The build ID of the executable
+            std::array<std::array<u64, 4>, 3> segmentHashes; //!< The SHA256 checksums of the .text, .rodata and .data segments
+
+            bool operator==(const Identifier &) const = default;
+        };
+
+        std::optional<Identifier> identifier; //!< The identifier of the executable, the patched code of the executable is cached if this is present
+
+        accounting::Allocation allocation{accounting::Category::Loader}; //!< The attribution of the contents of all segments, this is updated by the reader of the executable
     };
 }
@@ -7,6 +7,7 @@
 #include <os.h>
 #include <kernel/types/KProcess.h>
 #include <kernel/memory.h>
+#include "cache.h"
 #include "loader.h"
 
 namespace skyline::loader {
@@ -23,7 +24,13 @@ namespace skyline::loader {
         if (!util::PageAligned(executable.text.offset) || !util::PageAligned(executable.ro.offset) || !util::PageAligned(executable.data.offset))
             throw exception("LoadProcessData: Section offsets are not aligned with page size: 0x{:X}, 0x{:X}, 0x{:X}", executable.text.offset, executable.ro.offset, executable.data.offset);
 
-        auto patch{state.nce->GetPatchData(executable.text.contents)};
+        // The patched code of identifiable executables is cached, a cache hit skips scanning and patching the code entirely
+        std::optional<PatchCache> cache;
+        if (executable.identifier)
+            cache.emplace(state, *executable.identifier);
+        bool cached{cache && cache->Valid() && cache->text.size() == textSize};
+
+        auto patch{cached ? nce::NCE::PatchData{cache->patch.size()} : state.nce->GetPatchData(executable.text.contents)};
         auto size{patch.size + textSize + roSize + dataSize};
 
         process->NewHandle<kernel::type::KPrivateMemory>(base, patch.size, memory::Permission{false, false, false}, memory::states::Reserved); // ---
@@ -38,8 +45,17 @@ namespace skyline::loader {
         process->NewHandle<kernel::type::KPrivateMemory>(base + patch.size + executable.data.offset, dataSize, memory::Permission{true, true, false}, memory::states::CodeMutable); // RW-
         state.logger->Debug("Successfully mapped section .data + .bss @ 0x{:X}, Size = 0x{:X}", base + patch.size + executable.data.offset, dataSize);
 
-        state.nce->PatchCode(executable.text.contents, reinterpret_cast<u32 *>(base), patch.size, patch.offsets);
-        std::memcpy(base + patch.size + executable.text.offset, executable.text.contents.data(), textSize);
+        if (cached) {
+            std::memcpy(base, cache->patch.data(), patch.size);
+            state.nce->PatchCode(executable.text.contents, reinterpret_cast<u32 *>(base), patch.size, {}); // The main SVC trampoline contains host addresses which aren't constant across runs
+            std::memcpy(base + patch.size + executable.text.offset, cache->text.data(), textSize);
+            state.logger->Debug("Loaded patched code of '{}' from the cache", name);
+        } else {
+            state.nce->PatchCode(executable.text.contents, reinterpret_cast<u32 *>(base), patch.size, patch.offsets);
+            std::memcpy(base + patch.size + executable.text.offset, executable.text.contents.data(), textSize);
+            if (cache)
+                cache->Store(span<u8>(base, patch.size), executable.text.contents);
+        }
         std::memcpy(base + patch.size + executable.ro.offset, executable.ro.contents.data(), roSize);
         std::memcpy(base + patch.size + executable.data.offset, executable.data.contents.data(), dataSize - executable.bssSize);
 
@@ -53,18 +69,44 @@ namespace skyline::loader {
             .symbols = span(reinterpret_cast<Elf64_Sym *>(rodataOffset + executable.dynsym.offset), executable.dynsym.size / sizeof(Elf64_Sym)),
             .symbolStrings = span(reinterpret_cast<char *>(rodataOffset + executable.dynstr.offset), executable.dynstr.size),
         };
-        executables.insert(std::upper_bound(executables.begin(), executables.end(), base, [](void *ptr, const ExecutableSymbolicInfo &it) { return ptr < it.patchStart; }), symbolicInfo);
+
+        // The symbol index is built before the executable is published so lookups never need to modify it
+        auto &index{symbolicInfo.symbolIndex};
+        for (const auto &symbol : symbolicInfo.symbols)
+            if (symbol.st_size)
+                index.push_back(&symbol);
+        std::sort(index.begin(), index.end(), [](const Elf64_Sym *a, const Elf64_Sym *b) { return a->st_value < b->st_value; });
+
+        symbolicInfo.symbolIndexEnds.reserve(index.size());
+        u64 highestEnd{};
+        for (auto symbol : index)
+            symbolicInfo.symbolIndexEnds.push_back(highestEnd = std::max(highestEnd, symbol->st_value + symbol->st_size));
+
+        std::unique_lock lock{symbolMutex};
+        executables.insert(std::upper_bound(executables.begin(), executables.end(), base, [](void *ptr, const ExecutableSymbolicInfo &it) { return ptr < it.patchStart; }), std::move(symbolicInfo));
 
         return {base, size, base + patch.size};
     }
 
-    Loader::SymbolInfo Loader::ResolveSymbol(void *ptr) {
+    Loader::SymbolInfo Loader::ResolveSymbolLocked(void *ptr) {
         auto executable{std::lower_bound(executables.begin(), executables.end(), ptr, [](const ExecutableSymbolicInfo &it, void *ptr) { return it.programEnd < ptr; })};
         if (executable != executables.end() && ptr >= executable->patchStart && ptr <= executable->programEnd) {
             if (ptr >= executable->programStart) {
-                auto offset{reinterpret_cast<u8 *>(ptr) - reinterpret_cast<u8 *>(executable->programStart)};
-                auto symbol{std::find_if(executable->symbols.begin(), executable->symbols.end(), [&offset](const Elf64_Sym &sym) { return sym.st_value <= offset && sym.st_value + sym.st_size > offset; })};
-                if (symbol != executable->symbols.end() && symbol->st_name && symbol->st_name < executable->symbolStrings.size()) {
+                auto offset{static_cast<u64>(reinterpret_cast<u8 *>(ptr) - reinterpret_cast<u8 *>(executable->programStart))};
+                auto &index{executable->symbolIndex};
+                auto &ends{executable->symbolIndexEnds};
+
+                // Symbols can be nested or overlap, every symbol starting at or below the offset is checked from the highest address downwards till none prior to it can reach the offset
+                // The symbol that comes first in .dynsym is used out of all the ones containing the offset, this matches a linear search over .dynsym
+                const Elf64_Sym *symbol{};
+                auto position{static_cast<size_t>(std::upper_bound(index.begin(), index.end(), offset, [](u64 offset, const Elf64_Sym *symbol) { return offset < symbol->st_value; }) - index.begin())};
+                for (; position && ends[position - 1] > offset; position--) {
+                    auto candidate{index[position - 1]};
+                    if (candidate->st_value + candidate->st_size > offset && (!symbol || candidate < symbol))
+                        symbol = candidate;
+                }
+
+                if (symbol && symbol->st_name && symbol->st_name < executable->symbolStrings.size()) {
                     return {executable->symbolStrings.data() + symbol->st_name, executable->name};
                 } else {
                     return {.executableName = executable->name};
@@ -76,15 +118,38 @@ namespace skyline::loader {
         return {};
     }
 
+    Loader::SymbolInfo Loader::ResolveSymbol(void *ptr) {
+        std::shared_lock lock{symbolMutex};
+        return ResolveSymbolLocked(ptr);
+    }
+
+    std::vector<Loader::SymbolInfo> Loader::ResolveSymbols(span<void *const> ptrs) {
+        std::vector<SymbolInfo> symbols;
+        symbols.reserve(ptrs.size());
+
+        std::shared_lock lock{symbolMutex};
+        for (auto ptr : ptrs)
+            symbols.push_back(ResolveSymbolLocked(ptr));
+        return symbols;
+    }
+
+    std::string_view Loader::Demangle(const char *name) {
+        std::lock_guard guard{demangleMutex};
+        auto it{demangledNames.find(name)};
+        if (it == demangledNames.end()) {
+            int status{};
+            size_t length{};
+            std::unique_ptr<char, decltype(&std::free)> demangled{abi::__cxa_demangle(name, nullptr, &length, &status), std::free};
+            it = demangledNames.emplace(name, (status == 0) ? std::string(demangled.get()) : std::string{}).first;
+        }
+        return it->second.empty() ? std::string_view{name} : std::string_view{it->second};
+    }
+
     inline std::string GetFunctionStackTrace(Loader *loader, void *pointer) {
         Dl_info info;
         auto symbol{loader->ResolveSymbol(pointer)};
         if (symbol.name) {
-            int status{};
-            size_t length{};
-            std::unique_ptr<char, decltype(&std::free)> demangled{abi::__cxa_demangle(symbol.name, nullptr, &length, &status), std::free};
-
-            return fmt::format("\n* 0x{:X} ({} from {})", reinterpret_cast<uintptr_t>(pointer), (status == 0) ? std::string(demangled.get()) : symbol.name, symbol.executableName);
+            return fmt::format("\n* 0x{:X} ({} from {})", reinterpret_cast<uintptr_t>(pointer), loader->Demangle(symbol.name), symbol.executableName);
         } else if (!symbol.executableName.empty()) {
             return fmt::format("\n* 0x{:X} (from {})", reinterpret_cast<uintptr_t>(pointer), symbol.executableName);
         } else if (dladdr(pointer, &info)) {
@@ -60,9 +60,21 @@ namespace skyline::loader {
             std::string patchName; //!< The name of the patch section
             span<Elf64_Sym> symbols; //!< A span over the .dynsym section
             span<char> symbolStrings; //!< A span over the .dynstr section
+            std::vector<const Elf64_Sym *> symbolIndex; //!< All symbols with a non-zero size sorted by their address, this is built prior to the executable being published
+            std::vector<u64> symbolIndexEnds; //!< The highest end address of any symbol in symbolIndex up to and including the corresponding position, this bounds the backwards search for symbols containing an address
         };
 
         std::vector<ExecutableSymbolicInfo> executables;
+        std::shared_mutex symbolMutex; //!< Synchronizes access to the executables, lookups are done in shared mode while loading executables is done in exclusive mode
+
+        std::unordered_map<const char *, std::string> demangledNames; //!< A cache of demangled names keyed by the address of their mangled name, an empty string denotes a name which couldn't be demangled
+        std::mutex demangleMutex; //!< Synchronizes access to demangledNames
+
+        /**
+         * @brief Finds the symbol for an address with the symbol index of the executable containing it
+         * @note symbolMutex **must** be locked in shared mode by the calling thread prior to calling this
+         */
+        SymbolInfo ResolveSymbolLocked(void *ptr);
 
       public:
         /**
@@ -110,6 +122,18 @@ namespace skyline::loader {
          */
         SymbolInfo ResolveSymbol(void *ptr);
 
+        /**
+         * @brief Resolves the symbols of multiple addresses at once, this is faster than calling ResolveSymbol for every address as locks are only acquired once
+         * @return The symbolic information for every address in the same order as the supplied addresses
+         */
+        std::vector<SymbolInfo> ResolveSymbols(span<void *const> ptrs);
+
+        /**
+         * @return The demangled form of the supplied name or the name itself if it couldn't be demangled
+         * @note The demangled name is cached and the view is valid for the lifetime of the Loader, the name must also remain valid for as long as the Loader exists
+         */
+        std::string_view Demangle(const char *name);
+
         /**
          * @param frame The initial stack frame or the calling function's stack frame by default
          * @return A string with the stack trace based on the supplied context
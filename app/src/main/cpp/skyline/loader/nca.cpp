@@ -1,13 +1,14 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <common/worker_pool.h>
 #include <kernel/types/KProcess.h>
 #include <vfs/npdm.h>
 #include "nso.h"
 #include "nca.h"
 
 namespace skyline::loader {
-    NcaLoader::NcaLoader(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore) : nca(std::move(backing), std::move(keyStore)) {
+    NcaLoader::NcaLoader(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore, size_t romFsCacheSize) : nca(std::move(backing), std::move(keyStore), false, romFsCacheSize) {
         if (nca.exeFs == nullptr)
             throw exception("Only NCAs with an ExeFS can be loaded directly");
     }
@@ -19,25 +20,32 @@ namespace skyline::loader {
         if (!exeFs->FileExists("rtld"))
             throw exception("Cannot load an ExeFS that doesn't contain rtld");
 
-        auto nsoFile{exeFs->OpenFile("rtld")};
-
         state.process->memory.InitializeVmm(process->npdm.meta.flags.type);
 
-        auto loadInfo{NsoLoader::LoadNso(loader, nsoFile, process, state, 0, "rtld.nso")};
-        u64 offset{loadInfo.size};
-        u8 *base{loadInfo.base};
-        void *entry{loadInfo.entry};
-
-        state.logger->Info("Loaded 'rtld.nso' at 0x{:X} (.text @ 0x{:X})", base, entry);
-
-        for (const auto &nso : {"main", "subsdk0", "subsdk1", "subsdk2", "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7", "sdk"}) {
+        std::vector<std::pair<std::string, std::shared_ptr<vfs::Backing>>> nsos;
+        for (const auto &nso : {"rtld", "main", "subsdk0", "subsdk1", "subsdk2", "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7", "sdk"})
             if (exeFs->FileExists(nso))
-                nsoFile = exeFs->OpenFile(nso);
-            else
-                continue;
-
-            loadInfo = NsoLoader::LoadNso(loader, nsoFile, process, state, offset, nso + std::string(".nso"));
-            state.logger->Info("Loaded '{}.nso' at 0x{:X} (.text @ 0x{:X})", nso, base + offset, loadInfo.entry);
+                nsos.emplace_back(nso + std::string(".nso"), exeFs->OpenFile(nso));
+
+        // All NSOs are read and decompressed concurrently on the shared WorkerPool, they're loaded in order afterwards as the offset of each NSO depends on the size of all prior NSOs
+        std::vector<Executable> executables(nsos.size());
+        WorkerPool::Get().ParallelFor(nsos.size(), [&](size_t index) {
+            executables[index] = NsoLoader::ReadNso(nsos[index].second);
+        });
+
+        u64 offset{};
+        u8 *base{};
+        void *entry{};
+        for (size_t index{}; index < nsos.size(); index++) {
+            auto &name{nsos[index].first};
+            auto &executable{executables[index]};
+            auto loadInfo{loader->LoadExecutable(process, state, executable, offset, name)};
+            if (!base) {
+                base = loadInfo.base;
+                entry = loadInfo.entry;
+            }
+
+            state.logger->Info("Loaded '{}' at 0x{:X} (.text @ 0x{:X})", name, base + offset, loadInfo.entry);
             offset += loadInfo.size;
         }
 
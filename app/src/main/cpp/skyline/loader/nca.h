@@ -16,7 +16,10 @@ namespace skyline::loader {
         vfs::NCA nca; //!< The backing NCA of the loader
 
       public:
-        NcaLoader(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore);
+        /**
+         * @param romFsCacheSize The memory budget of the cache for decrypted RomFS data in bytes, 0 disables caching
+         */
+        NcaLoader(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore, size_t romFsCacheSize = 0);
 
         /**
          * @brief Loads an ExeFS into memory and processes it accordingly for execution
@@ -56,6 +56,8 @@ namespace skyline::loader {
         executable.data.contents = GetSegment(header.data);
         executable.data.offset = header.text.size + header.ro.size;
 
+        executable.allocation.Resize(executable.text.contents.size() + executable.ro.contents.size() + executable.data.contents.size());
+
         executable.bssSize = header.bssSize;
 
         if (header.dynsym.offset > header.ro.offset && header.dynsym.offset + header.dynsym.size < header.ro.offset + header.ro.size && header.dynstr.offset > header.ro.offset && header.dynstr.offset + header.dynstr.size < header.ro.offset + header.ro.size) {
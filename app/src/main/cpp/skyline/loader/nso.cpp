@@ -3,6 +3,7 @@
 
 #include <lz4.h>
 #include <nce.h>
+#include <common/worker_pool.h>
 #include <kernel/types/KProcess.h>
 #include "nso.h"
 
@@ -14,22 +15,31 @@ namespace skyline::loader {
             throw exception("Invalid NSO magic! 0x{0:X}", magic);
     }
 
-    std::vector<u8> NsoLoader::GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize) {
-        std::vector<u8> outputBuffer(segment.decompressedSize);
+    std::vector<u8> NsoLoader::GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize, size_t alignment) {
+        // The buffer is allocated with the aligned size upfront as resizing it afterwards would reallocate and copy the entire segment
+        std::vector<u8> outputBuffer(util::AlignUp(segment.decompressedSize, alignment));
 
         if (compressedSize) {
-            std::vector<u8> compressedBuffer(compressedSize);
-            backing->Read(compressedBuffer, segment.fileOffset);
-
-            LZ4_decompress_safe(reinterpret_cast<char *>(compressedBuffer.data()), reinterpret_cast<char *>(outputBuffer.data()), compressedSize, segment.decompressedSize);
+            // The compressed data is decompressed directly from the backing when it's in memory, it's only copied into an intermediate buffer otherwise
+            std::vector<u8> compressedBuffer;
+            span<const u8> compressed{backing->GetSpan(segment.fileOffset, compressedSize)};
+            if (compressed.empty()) {
+                compressedBuffer.resize(compressedSize);
+                backing->Read(compressedBuffer, segment.fileOffset);
+                compressed = compressedBuffer;
+            }
+
+            auto decompressedSize{LZ4_decompress_safe(reinterpret_cast<const char *>(compressed.data()), reinterpret_cast<char *>(outputBuffer.data()), compressedSize, segment.decompressedSize)};
+            if (decompressedSize != segment.decompressedSize)
+                throw exception("Failed to decompress NSO segment: {} (Expected 0x{:X} bytes)", decompressedSize, segment.decompressedSize);
         } else {
-            backing->Read(outputBuffer, segment.fileOffset);
+            backing->Read(span(outputBuffer).first(segment.decompressedSize), segment.fileOffset);
         }
 
         return outputBuffer;
     }
 
-    Loader::ExecutableLoadInfo NsoLoader::LoadNso(Loader *loader, const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, size_t offset, const std::string &name) {
+    Executable NsoLoader::ReadNso(const std::shared_ptr<vfs::Backing> &backing) {
         auto header{backing->Read<NsoHeader>()};
 
         if (header.magic != util::MakeMagic<u32>("NSO0"))
@@ -37,16 +47,25 @@ namespace skyline::loader {
 
         Executable executable{};
 
-        executable.text.contents = GetSegment(backing, header.text, header.flags.textCompressed ? header.textCompressedSize : 0);
-        executable.text.contents.resize(util::AlignUp(executable.text.contents.size(), PAGE_SIZE));
-        executable.text.offset = header.text.memoryOffset;
-
-        executable.ro.contents = GetSegment(backing, header.ro, header.flags.roCompressed ? header.roCompressedSize : 0);
-        executable.ro.contents.resize(util::AlignUp(executable.ro.contents.size(), PAGE_SIZE));
-        executable.ro.offset = header.ro.memoryOffset;
-
-        executable.data.contents = GetSegment(backing, header.data, header.flags.dataCompressed ? header.dataCompressedSize : 0);
-        executable.data.offset = header.data.memoryOffset;
+        // The segments are independent of each other so they're decompressed concurrently on the shared WorkerPool
+        struct SegmentRead {
+            const NsoSegmentHeader &header;
+            u32 compressedSize;
+            size_t alignment;
+            Executable::Segment &segment;
+        };
+        std::array<SegmentRead, 3> segments{{
+            {header.text, header.flags.textCompressed ? header.textCompressedSize : 0, PAGE_SIZE, executable.text},
+            {header.ro, header.flags.roCompressed ? header.roCompressedSize : 0, PAGE_SIZE, executable.ro},
+            {header.data, header.flags.dataCompressed ? header.dataCompressedSize : 0, 1, executable.data},
+        }};
+        WorkerPool::Get().ParallelFor(segments.size(), [&](size_t index) {
+            auto &read{segments[index]};
+            read.segment.contents = GetSegment(backing, read.header, read.compressedSize, read.alignment);
+            read.segment.offset = read.header.memoryOffset;
+        });
+
+        executable.allocation.Resize(executable.text.contents.size() + executable.ro.contents.size() + executable.data.contents.size());
 
         // Data and BSS are aligned together
         executable.bssSize = util::AlignUp(executable.data.contents.size() + header.bssSize, PAGE_SIZE) - executable.data.contents.size();
@@ -56,6 +75,14 @@ namespace skyline::loader {
             executable.dynstr = {header.dynstr.offset, header.dynstr.size};
         }
 
+        if (std::any_of(header.buildId.begin(), header.buildId.end(), [](u64 value) { return value != 0; }))
+            executable.identifier = Executable::Identifier{header.buildId, header.segmentHashes};
+
+        return executable;
+    }
+
+    Loader::ExecutableLoadInfo NsoLoader::LoadNso(Loader *loader, const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, size_t offset, const std::string &name) {
+        auto executable{ReadNso(backing)};
         return loader->LoadExecutable(process, state, executable, offset, name);
     }
 
@@ -73,13 +73,20 @@ namespace skyline::loader {
          * @brief Reads the specified segment from the backing and decompresses it if needed
          * @param segment The header of the segment to read
          * @param compressedSize The compressed size of the segment, 0 if the segment is not compressed
+         * @param alignment The alignment of the size of the returned buffer, any padding is zero-filled
          * @return A buffer containing the data of the requested segment
          */
-        static std::vector<u8> GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize);
+        static std::vector<u8> GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize, size_t alignment = 1);
 
       public:
         NsoLoader(std::shared_ptr<vfs::Backing> backing);
 
+        /**
+         * @brief Reads an NSO and decompresses all of its segments, this is independent of any process so it can be done concurrently for multiple NSOs
+         * @param backing The backing that the NSO is contained within
+         */
+        static Executable ReadNso(const std::shared_ptr<vfs::Backing> &backing);
+
         /**
          * @brief Loads an NSO into memory, offset by the given amount
          * @param backing The backing that the NSO is contained within
@@ -22,7 +22,7 @@ namespace skyline::loader {
         }
     }
 
-    NspLoader::NspLoader(const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<crypto::KeyStore> &keyStore) : nsp(std::make_shared<vfs::PartitionFileSystem>(backing)) {
+    NspLoader::NspLoader(const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<crypto::KeyStore> &keyStore, size_t romFsCacheSize) : nsp(std::make_shared<vfs::PartitionFileSystem>(backing)) {
         ExtractTickets(nsp, keyStore);
 
         auto root{nsp->OpenDirectory("", {false, true})};
@@ -31,7 +31,7 @@ namespace skyline::loader {
                 continue;
 
             try {
-                auto nca{vfs::NCA(nsp->OpenFile(entry.name), keyStore)};
+                auto nca{vfs::NCA(nsp->OpenFile(entry.name), keyStore, false, romFsCacheSize)};
 
                 if (nca.contentType == vfs::NcaContentType::Program && nca.romFs != nullptr && nca.exeFs != nullptr)
                     programNca = std::move(nca);
@@ -8,7 +8,7 @@
 #include "xci.h"
 
 namespace skyline::loader {
-    XciLoader::XciLoader(const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<crypto::KeyStore> &keyStore) {
+    XciLoader::XciLoader(const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<crypto::KeyStore> &keyStore, size_t romFsCacheSize) {
         header = backing->Read<GamecardHeader>();
 
         if (header.magic != util::MakeMagic<u32>("HEAD"))
@@ -36,7 +36,7 @@ namespace skyline::loader {
                     continue;
 
                 try {
-                    auto nca{vfs::NCA(secure->OpenFile(entry.name), keyStore, true)};
+                    auto nca{vfs::NCA(secure->OpenFile(entry.name), keyStore, true, romFsCacheSize)};
 
                     if (nca.contentType == vfs::NcaContentType::Program && nca.romFs != nullptr && nca.exeFs != nullptr)
                         programNca = std::move(nca);
@@ -115,7 +115,10 @@ namespace skyline::loader {
         std::optional<vfs::NCA> controlNca; //!< The main control NCA within the secure partition
 
       public:
-        XciLoader(const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<crypto::KeyStore> &keyStore);
+        /**
+         * @param romFsCacheSize The memory budget of the cache for decrypted RomFS data in bytes, 0 disables caching
+         */
+        XciLoader(const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<crypto::KeyStore> &keyStore, size_t romFsCacheSize = 0);
 
         std::vector<u8> GetIcon() override;
 
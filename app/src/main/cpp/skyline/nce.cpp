@@ -2,8 +2,11 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <cxxabi.h>
+#include <numeric>
+#include <optional>
 #include <unistd.h>
 #include "common/signal.h"
+#include "common/worker_pool.h"
 #include "common/trace.h"
 #include "os.h"
 #include "jvm.h"
@@ -22,7 +25,9 @@ namespace skyline::nce {
         try {
             if (svc) [[likely]] {
                 TRACE_EVENT("kernel", perfetto::StaticString{svc.name});
+                auto start{util::GetTimeNs()};
                 (svc.function)(state);
+                state.nce->svcStatistics.Record(svcId, util::GetTimeNs() - start);
             } else {
                 throw exception("Unimplemented SVC 0x{:X}", svcId);
             }
@@ -114,55 +119,365 @@ namespace skyline::nce {
     constexpr u32 CntvctEl0{0x5F02};        // ID of CNTVCT_EL0 in MRS
     constexpr u32 TegraX1Freq{19200000};    // The clock frequency of the Tegra X1 (19.2 MHz)
 
-    NCE::PatchData NCE::GetPatchData(const std::vector<u8> &text) {
-        size_t size{guest::SaveCtxSize + guest::LoadCtxSize + MainSvcTrampolineSize};
+    constexpr u16 SvcGetThreadPriority{0x0C};
+    constexpr u16 SvcGetCurrentProcessorNumber{0x10};
+    constexpr u16 SvcArbitrateUnlock{0x1B};
+    constexpr u16 SvcGetSystemTick{0x1E};
+    constexpr u16 SvcGetThreadId{0x25};
+
+    /**
+     * @return The amount of registers starting from X0 that need to be saved and restored around an SVC, this is rounded up to a pair of registers
+     */
+    constexpr u8 GetSvcSavedRegisters(u16 svcId) {
+        return (svcId < kernel::svc::SvcTable.size()) ? util::AlignUp(kernel::svc::SvcTable[svcId].registers, 2) : 0;
+    }
+
+    /**
+     * @return The size of the trampoline for an SVC in u32 units, this includes any fast path for it which is handled entirely in guest code
+     */
+    constexpr size_t GetSvcTrampolineSize(u16 svcId, bool rescaleClock) {
+        size_t size{7 + GetSvcSavedRegisters(svcId)}; // A pair of registers takes a single instruction to save and another to restore
+        switch (svcId) {
+            case SvcGetThreadPriority:
+                return 7 + size;
+            case SvcGetCurrentProcessorNumber:
+                return 4;
+            case SvcArbitrateUnlock:
+                return 12 + size;
+            case SvcGetSystemTick:
+                return rescaleClock ? guest::RescaleClockSize + 3 : 2;
+            case SvcGetThreadId:
+                return 6 + size;
+            default:
+                return size;
+        }
+    }
+
+    /**
+     * @return The size of the trampoline for an instruction in u32 units or std::nullopt if the instruction doesn't need to be patched
+     * @note A size of 0 denotes an instruction which is patched in-place without a trampoline
+     */
+    std::optional<size_t> GetTrampolineSize(u32 instruction, bool rescaleClock) {
+        auto svc{*reinterpret_cast<const instructions::Svc *>(&instruction)};
+        auto mrs{*reinterpret_cast<const instructions::Mrs *>(&instruction)};
+        auto msr{*reinterpret_cast<const instructions::Msr *>(&instruction)};
+
+        if (svc.Verify()) {
+            return GetSvcTrampolineSize(svc.value, rescaleClock);
+        } else if (mrs.Verify()) {
+            if (mrs.srcReg == TpidrroEl0 || mrs.srcReg == TpidrEl0) {
+                return (mrs.destReg != registers::X0) ? 6 : 3;
+            } else {
+                if (rescaleClock) {
+                    if (mrs.srcReg == CntpctEl0)
+                        return guest::RescaleClockSize + 3;
+                    else if (mrs.srcReg == CntfrqEl0)
+                        return 3;
+                } else if (mrs.srcReg == CntpctEl0) {
+                    return 0;
+                }
+            }
+        } else if (msr.Verify() && msr.destReg == TpidrEl0) {
+            return 6;
+        }
+        return std::nullopt;
+    }
+
+    constexpr size_t ScanChunkSize{0x40000}; //!< The minimum amount of instructions in a chunk of code that's scanned on a separate thread (1MiB)
+    constexpr size_t PatchChunkSize{0x1000}; //!< The minimum amount of patched instructions in a chunk that's patched on a separate thread
+
+    /**
+     * @return The amount of chunks that work of the supplied size should be split into, this is bounded by the parallelism of the shared WorkerPool
+     */
+    size_t GetChunkCount(size_t size, size_t minimumChunkSize) {
+        return std::clamp<size_t>(size / minimumChunkSize, 1, WorkerPool::Get().Parallelism());
+    }
+
+    /**
+     * @brief Runs a function for every chunk of a range in parallel on the shared WorkerPool, the calling thread processes chunks as well
+     * @param function A function which is supplied the index of the chunk alongside the start and end of it in the range
+     */
+    template<typename Function>
+    void ForEachChunk(size_t chunkCount, size_t size, Function function) {
+        WorkerPool::Get().ParallelFor(chunkCount, [&](size_t chunk) {
+            function(chunk, (size * chunk) / chunkCount, (size * (chunk + 1)) / chunkCount);
+        });
+    }
+
+    /**
+     * @brief Scans the text for instructions that need to be patched, this is split into the supplied amount of chunks
+     * @note The offsets from every chunk are concatenated in order afterwards so the result is identical to a serial scan
+     */
+    NCE::PatchData ScanCode(const std::vector<u8> &text, bool rescaleClock, size_t chunkCount) {
+        auto start{reinterpret_cast<const u32 *>(text.data())};
+        size_t instructionCount{text.size() / sizeof(u32)};
+        std::vector<std::vector<size_t>> chunkOffsets(chunkCount);
+        std::vector<size_t> chunkSizes(chunkCount);
+        ForEachChunk(chunkCount, instructionCount, [&](size_t chunk, size_t chunkStart, size_t chunkEnd) {
+            auto &offsets{chunkOffsets[chunk]};
+            auto &size{chunkSizes[chunk]};
+            for (size_t offset{chunkStart}; offset < chunkEnd; offset++) {
+                if (auto trampolineSize{GetTrampolineSize(start[offset], rescaleClock)}) {
+                    size += *trampolineSize;
+                    offsets.push_back(offset);
+                }
+            }
+        });
+
+        size_t size{MainSvcTrampolineSize};
         std::vector<size_t> offsets;
+        offsets.reserve(std::accumulate(chunkOffsets.begin(), chunkOffsets.end(), size_t{}, [](size_t count, const std::vector<size_t> &offsets) { return count + offsets.size(); }));
+        for (size_t chunk{}; chunk < chunkCount; chunk++) {
+            size += chunkSizes[chunk];
+            offsets.insert(offsets.end(), chunkOffsets[chunk].begin(), chunkOffsets[chunk].end());
+        }
 
-        u64 frequency;
-        asm("MRS %0, CNTFRQ_EL0" : "=r"(frequency));
-        bool rescaleClock{frequency != TegraX1Freq};
+        return {util::AlignUp(size * sizeof(u32), PAGE_SIZE), offsets};
+    }
+
+    /**
+     * @brief Writes the trampolines for all instructions at the supplied offsets and rewrites the instructions to branch to them, this is split into the supplied amount of chunks
+     * @param start The start of the .patch section, the trampolines are written after the main SVC trampoline
+     * @param end The end of the .patch section which is directly followed by the instructions
+     * @note Every chunk starts after all the trampolines of prior chunks so the result is identical to writing them serially
+     * @return A pointer past the last trampoline that was written
+     */
+    u32 *WriteTrampolines(u32 *instructions, u32 *start, u32 *end, const std::vector<size_t> &offsets, bool rescaleClock, size_t chunkCount) {
+        std::vector<size_t> chunkSizes(chunkCount);
+        ForEachChunk(chunkCount, offsets.size(), [&](size_t chunk, size_t chunkStart, size_t chunkEnd) {
+            for (size_t index{chunkStart}; index < chunkEnd; index++)
+                chunkSizes[chunk] += *GetTrampolineSize(instructions[offsets[index]], rescaleClock);
+        });
+
+        std::vector<u32 *> chunkPatches(chunkCount + 1);
+        chunkPatches[0] = start + MainSvcTrampolineSize; // The trampolines for instructions always start at a fixed offset regardless of the size of the main trampoline, this makes them independent of the host address of the SVC handler
+        for (size_t chunk{}; chunk < chunkCount; chunk++)
+            chunkPatches[chunk + 1] = chunkPatches[chunk] + chunkSizes[chunk];
+
+        ForEachChunk(chunkCount, offsets.size(), [&](size_t chunk, size_t chunkStart, size_t chunkEnd) {
+            u32 *patch{chunkPatches[chunk]};
+            for (size_t index{chunkStart}; index < chunkEnd; index++) {
+                auto offset{offsets[index]};
+                u32 *instruction{instructions + offset};
+                auto svc{*reinterpret_cast<instructions::Svc *>(instruction)};
+                auto mrs{*reinterpret_cast<instructions::Mrs *>(instruction)};
+                auto msr{*reinterpret_cast<instructions::Msr *>(instruction)};
+
+                if (svc.Verify()) {
+                    /* Per-SVC Trampoline */
+                    /* Rewrite SVC with B to trampoline */
+                    *instruction = instructions::B((end - patch) + offset, true).raw;
+
+                    /* Fast Path */
+                    // Frequently used SVCs which only read thread state or uncontended state are handled entirely in guest code, they fall back to the main SVC trampoline otherwise
+                    bool fastPathOnly{};
+                    switch (svc.value) {
+                        case SvcGetThreadPriority:
+                            /* Load priority of the current thread from ThreadContext */
+                            *patch++ = 0x3140203F; // CMN W1, #0x8000 (Check if the handle is 0xFFFF8000, the pseudo-handle of the current thread)
+                            *patch++ = 0x540000C1; // B.NE #24 (Full SVC)
+                            *patch++ = 0xD53BD041; // MRS X1, TPIDR_EL0
+                            *patch++ = 0xF9417021; // LDR X1, [X1, #0x2E0] (ThreadContext::priority)
+                            *patch++ = 0x39400021; // LDRB W1, [X1]
+                            *patch++ = 0x2A1F03E0; // MOV W0, WZR
+                            *patch = instructions::B((end - patch) + offset + 1).raw;
+                            patch++;
+                            break;
+
+                        case SvcGetCurrentProcessorNumber:
+                            /* Load core of the current thread from ThreadContext */
+                            *patch++ = 0xD53BD040; // MRS X0, TPIDR_EL0
+                            *patch++ = 0xF9416C00; // LDR X0, [X0, #0x2D8] (ThreadContext::coreId)
+                            *patch++ = 0x39C00000; // LDRSB W0, [X0]
+                            *patch = instructions::B((end - patch) + offset + 1).raw;
+                            patch++;
+                            fastPathOnly = true;
+                            break;
+
+                        case SvcArbitrateUnlock:
+                            /* Release the mutex if there are no waiters on it */
+                            // A thread can only wait on a mutex after setting HandleWaitersBit, an exclusive store ensures that it couldn't have been set prior to releasing the mutex
+                            *patch++ = 0xF240041F; // TST X0, #3
+                            *patch++ = 0x54000161; // B.NE #44 (Full SVC)
+                            *patch++ = 0xA9BF0BE1; // STP X1, X2, [SP, #-16]!
+                            *patch++ = 0x885FFC01; // LDAXR W1, [X0]
+                            *patch++ = 0x37F000C1; // TBNZ W1, #30, #24 (HandleWaitersBit)
+                            *patch++ = 0x8802FC1F; // STLXR W2, WZR, [X0]
+                            *patch++ = 0x35FFFFA2; // CBNZ W2, #-12 (LDAXR)
+                            *patch++ = 0xA8C10BE1; // LDP X1, X2, [SP], #16
+                            *patch++ = 0x2A1F03E0; // MOV W0, WZR
+                            *patch = instructions::B((end - patch) + offset + 1).raw;
+                            patch++;
+                            *patch++ = 0xD5033F5F; // CLREX
+                            *patch++ = 0xA8C10BE1; // LDP X1, X2, [SP], #16
+                            break;
+
+                        case SvcGetSystemTick:
+                            if (rescaleClock) {
+                                /* Rescale host clock */
+                                std::memcpy(patch, reinterpret_cast<void *>(&guest::RescaleClock), guest::RescaleClockSize * sizeof(u32));
+                                patch += guest::RescaleClockSize;
+
+                                /* Load result from stack and free 32B stack allocation by RescaleClock */
+                                *patch++ = 0xF94003E0; // LDR X0, [SP]
+                                *patch++ = {0x910083FF}; // ADD SP, SP, #32
+                            } else {
+                                *patch++ = instructions::Mrs(CntvctEl0, registers::X0).raw;
+                            }
+                            *patch = instructions::B((end - patch) + offset + 1).raw;
+                            patch++;
+                            fastPathOnly = true;
+                            break;
+
+                        case SvcGetThreadId:
+                            /* Load ID of the current thread from ThreadContext */
+                            *patch++ = 0x3140203F; // CMN W1, #0x8000 (Check if the handle is 0xFFFF8000, the pseudo-handle of the current thread)
+                            *patch++ = 0x540000A1; // B.NE #20 (Full SVC)
+                            *patch++ = 0xD53BD041; // MRS X1, TPIDR_EL0
+                            *patch++ = 0xF9416821; // LDR X1, [X1, #0x2D0] (ThreadContext::threadId)
+                            *patch++ = 0x2A1F03E0; // MOV W0, WZR
+                            *patch = instructions::B((end - patch) + offset + 1).raw;
+                            patch++;
+                            break;
 
-        auto start{reinterpret_cast<const u32 *>(text.data())}, end{reinterpret_cast<const u32 *>(text.data() + text.size())};
-        for (const u32 *instruction{start}; instruction < end; instruction++) {
-            auto svc{*reinterpret_cast<const instructions::Svc *>(instruction)};
-            auto mrs{*reinterpret_cast<const instructions::Mrs *>(instruction)};
-            auto msr{*reinterpret_cast<const instructions::Msr *>(instruction)};
-
-            if (svc.Verify()) {
-                size += 7;
-                offsets.push_back(instruction - start);
-            } else if (mrs.Verify()) {
-                if (mrs.srcReg == TpidrroEl0 || mrs.srcReg == TpidrEl0) {
-                    size += ((mrs.destReg != registers::X0) ? 6 : 3);
-                    offsets.push_back(instruction - start);
-                } else {
-                    if (rescaleClock) {
-                        if (mrs.srcReg == CntpctEl0) {
-                            size += guest::RescaleClockSize + 3;
-                            offsets.push_back(instruction - start);
-                        } else if (mrs.srcReg == CntfrqEl0) {
-                            size += 3;
-                            offsets.push_back(instruction - start);
+                        default:
+                            break;
+                    }
+
+                    if (fastPathOnly)
+                        continue;
+
+                    /* Save Context */
+                    // Only registers used by the SVC are saved as SVCs are invoked from functions following AAPCS64, any caller-saved registers are assumed to be clobbered by the caller
+                    // Callee-saved registers and the lower halves of V8-V15 are preserved by the host ABI, X18 is reserved on the host which leaves no FP state that needs to be saved
+                    u8 savedRegisters{GetSvcSavedRegisters(static_cast<u16>(svc.value))};
+                    *patch++ = 0xF81F0FFE; // STR LR, [SP, #-16]!
+                    *patch++ = 0xD53BD05E; // MRS LR, TPIDR_EL0
+                    for (u8 index{}; index < savedRegisters; index += 2)
+                        *patch++ = instructions::LoadStorePair(false, registers::X(index), registers::X(index + 1), registers::X30, index * sizeof(u64)).raw; // STP Xn, Xn+1, [LR, #(8 * n)]
+
+                    /* Jump to main SVC trampoline */
+                    *patch++ = instructions::Movz(registers::W0, static_cast<u16>(svc.value)).raw;
+                    *patch = instructions::BL(start - patch).raw;
+                    patch++;
+
+                    /* Restore Context and Return */
+                    *patch++ = 0xD53BD05E; // MRS LR, TPIDR_EL0
+                    for (u8 index{}; index < savedRegisters; index += 2)
+                        *patch++ = instructions::LoadStorePair(true, registers::X(index), registers::X(index + 1), registers::X30, index * sizeof(u64)).raw; // LDP Xn, Xn+1, [LR, #(8 * n)]
+                    *patch++ = 0xF84107FE; // LDR LR, [SP], #16
+                    *patch = instructions::B((end - patch) + offset + 1).raw;
+                    patch++;
+                } else if (mrs.Verify()) {
+                    if (mrs.srcReg == TpidrroEl0 || mrs.srcReg == TpidrEl0) {
+                        /* Emulated TLS Register Load */
+                        /* Rewrite MRS with B to trampoline */
+                        *instruction = instructions::B((end - patch) + offset, true).raw;
+
+                        /* Allocate Scratch Register */
+                        if (mrs.destReg != registers::X0)
+                            *patch++ = 0xF81F0FE0; // STR X0, [SP, #-16]!
+
+                        /* Retrieve emulated TLS register from ThreadContext */
+                        *patch++ = 0xD53BD040; // MRS X0, TPIDR_EL0
+                        if (mrs.srcReg == TpidrroEl0)
+                            *patch++ = 0xF9415800; // LDR X0, [X0, #0x2B0] (ThreadContext::tpidrroEl0)
+                        else
+                            *patch++ = 0xF9415C00; // LDR X0, [X0, #0x2B8] (ThreadContext::tpidrEl0)
+
+                        /* Restore Scratch Register and Return */
+                        if (mrs.destReg != registers::X0) {
+                            *patch++ = instructions::Mov(registers::X(mrs.destReg), registers::X0).raw;
+                            *patch++ = 0xF84107E0; // LDR X0, [SP], #16
+                        }
+                        *patch = instructions::B((end - patch) + offset + 1).raw;
+                        patch++;
+                    } else {
+                        if (rescaleClock) {
+                            if (mrs.srcReg == CntpctEl0) {
+                                /* Physical Counter Load Emulation (With Rescaling) */
+                                /* Rewrite MRS with B to trampoline */
+                                *instruction = instructions::B((end - patch) + offset, true).raw;
+
+                                /* Rescale host clock */
+                                std::memcpy(patch, reinterpret_cast<void *>(&guest::RescaleClock), guest::RescaleClockSize * sizeof(u32));
+                                patch += guest::RescaleClockSize;
+
+                                /* Load result from stack into destination register */
+                                instructions::Ldr ldr(0xF94003E0); // LDR XOUT, [SP]
+                                ldr.destReg = mrs.destReg;
+                                *patch++ = ldr.raw;
+
+                                /* Free 32B stack allocation by RescaleClock and Return */
+                                *patch++ = {0x910083FF}; // ADD SP, SP, #32
+                                *patch = instructions::B((end - patch) + offset + 1).raw;
+                                patch++;
+                            } else if (mrs.srcReg == CntfrqEl0) {
+                                /* Physical Counter Frequency Load Emulation */
+                                /* Rewrite MRS with B to trampoline */
+                                *instruction = instructions::B((end - patch) + offset, true).raw;
+
+                                /* Write back Tegra X1 Counter Frequency and Return */
+                                for (const auto &mov : instructions::MoveRegister(registers::X(mrs.destReg), TegraX1Freq))
+                                    *patch++ = mov;
+                                *patch = instructions::B((end - patch) + offset + 1).raw;
+                                patch++;
+                            }
+                        } else if (mrs.srcReg == CntpctEl0) {
+                            /* Physical Counter Load Emulation (Without Rescaling) */
+                            // We just convert CNTPCT_EL0 -> CNTVCT_EL0 as Linux doesn't allow access to the physical counter
+                            *instruction = instructions::Mrs(CntvctEl0, registers::X(mrs.destReg)).raw;
                         }
-                    } else if (mrs.srcReg == CntpctEl0) {
-                        offsets.push_back(instruction - start);
                     }
+                } else if (msr.Verify() && msr.destReg == TpidrEl0) {
+                    /* Emulated TLS Register Store */
+                    /* Rewrite MSR with B to trampoline */
+                    *instruction = instructions::B((end - patch) + offset, true).raw;
+
+                    /* Allocate Scratch Registers */
+                    bool x0x1{mrs.srcReg != registers::X0 && mrs.srcReg != registers::X1};
+                    *patch++ = x0x1 ? 0xA9BF07E0 : 0xA9BF0FE2; // STP X(0/2), X(1/3), [SP, #-16]!
+
+                    /* Store new TLS value into ThreadContext */
+                    *patch++ = x0x1 ? 0xD53BD040 : 0xD53BD042; // MRS X(0/2), TPIDR_EL0
+                    *patch++ = instructions::Mov(x0x1 ? registers::X1 : registers::X3, registers::X(msr.srcReg)).raw;
+                    *patch++ = x0x1 ? 0xF9015C01 : 0xF9015C03; // STR X(1/3), [X0, #0x4B8] (ThreadContext::tpidrEl0)
+
+                    /* Restore Scratch Registers and Return */
+                    *patch++ = x0x1 ? 0xA8C107E0 : 0xA8C10FE2; // LDP X(0/2), X(1/3), [SP], #16
+                    *patch = instructions::B((end - patch) + offset + 1).raw;
+                    patch++;
                 }
-            } else if (msr.Verify() && msr.destReg == TpidrEl0) {
-                size += 6;
-                offsets.push_back(instruction - start);
             }
+        });
+
+        return chunkPatches[chunkCount];
+    }
+
+    NCE::PatchData NCE::GetPatchData(const std::vector<u8> &text) {
+        u64 frequency;
+        asm("MRS %0, CNTFRQ_EL0" : "=r"(frequency));
+        bool rescaleClock{frequency != TegraX1Freq};
+
+        size_t chunkCount{GetChunkCount(text.size() / sizeof(u32), ScanChunkSize)};
+        auto patchData{ScanCode(text, rescaleClock, chunkCount)};
+
+        #ifndef NDEBUG
+        if (chunkCount > 1) {
+            // Debug builds verify that the chunked scan finds exactly what a serial scan would
+            auto serialPatchData{ScanCode(text, rescaleClock, 1)};
+            if (serialPatchData.size != patchData.size || serialPatchData.offsets != patchData.offsets)
+                throw exception("GetPatchData: Chunked scan differs from a serial scan: 0x{:X} instructions (0x{:X}) vs 0x{:X} instructions (0x{:X})", patchData.offsets.size(), patchData.size, serialPatchData.offsets.size(), serialPatchData.size);
         }
-        return {util::AlignUp(size * sizeof(u32), PAGE_SIZE), offsets};
+        #endif
+
+        return patchData;
     }
 
     void NCE::PatchCode(std::vector<u8> &text, u32 *patch, size_t patchSize, const std::vector<size_t> &offsets) {
         u32 *start{patch};
         u32 *end{patch + (patchSize / sizeof(u32))};
 
-        std::memcpy(patch, reinterpret_cast<void *>(&guest::SaveCtx), guest::SaveCtxSize * sizeof(u32));
-        patch += guest::SaveCtxSize;
-
         {
             /* Main SVC Trampoline */
             /* Store LR in 16B of pre-allocated stack */
@@ -197,120 +512,30 @@ namespace skyline::nce {
             *patch++ = 0xD65F03C0; // RET
         }
 
-        std::memcpy(patch, reinterpret_cast<void *>(&guest::LoadCtx), guest::LoadCtxSize * sizeof(u32));
-        patch += guest::LoadCtxSize;
-
         u64 frequency;
         asm("MRS %0, CNTFRQ_EL0" : "=r"(frequency));
         bool rescaleClock{frequency != TegraX1Freq};
 
-        for (auto offset : offsets) {
-            u32 *instruction{reinterpret_cast<u32 *>(text.data()) + offset};
-            auto svc{*reinterpret_cast<instructions::Svc *>(instruction)};
-            auto mrs{*reinterpret_cast<instructions::Mrs *>(instruction)};
-            auto msr{*reinterpret_cast<instructions::Msr *>(instruction)};
-
-            if (svc.Verify()) {
-                /* Per-SVC Trampoline */
-                /* Rewrite SVC with B to trampoline */
-                *instruction = instructions::B((end - patch) + offset, true).raw;
-
-                /* Save Context */
-                *patch++ = 0xF81F0FFE; // STR LR, [SP, #-16]!
-                *patch = instructions::BL(start - patch).raw;
-                patch++;
-
-                /* Jump to main SVC trampoline */
-                *patch++ = instructions::Movz(registers::W0, static_cast<u16>(svc.value)).raw;
-                *patch = instructions::BL((start - patch) + guest::SaveCtxSize).raw;
-                patch++;
-
-                /* Restore Context and Return */
-                *patch = instructions::BL((start - patch) + guest::SaveCtxSize + MainSvcTrampolineSize).raw;
-                patch++;
-                *patch++ = 0xF84107FE; // LDR LR, [SP], #16
-                *patch = instructions::B((end - patch) + offset + 1).raw;
-                patch++;
-            } else if (mrs.Verify()) {
-                if (mrs.srcReg == TpidrroEl0 || mrs.srcReg == TpidrEl0) {
-                    /* Emulated TLS Register Load */
-                    /* Rewrite MRS with B to trampoline */
-                    *instruction = instructions::B((end - patch) + offset, true).raw;
-
-                    /* Allocate Scratch Register */
-                    if (mrs.destReg != registers::X0)
-                        *patch++ = 0xF81F0FE0; // STR X0, [SP, #-16]!
-
-                    /* Retrieve emulated TLS register from ThreadContext */
-                    *patch++ = 0xD53BD040; // MRS X0, TPIDR_EL0
-                    if (mrs.srcReg == TpidrroEl0)
-                        *patch++ = 0xF9415800; // LDR X0, [X0, #0x2B0] (ThreadContext::tpidrroEl0)
-                    else
-                        *patch++ = 0xF9415C00; // LDR X0, [X0, #0x2B8] (ThreadContext::tpidrEl0)
-
-                    /* Restore Scratch Register and Return */
-                    if (mrs.destReg != registers::X0) {
-                        *patch++ = instructions::Mov(registers::X(mrs.destReg), registers::X0).raw;
-                        *patch++ = 0xF84107E0; // LDR X0, [SP], #16
-                    }
-                    *patch = instructions::B((end - patch) + offset + 1).raw;
-                    patch++;
-                } else {
-                    if (rescaleClock) {
-                        if (mrs.srcReg == CntpctEl0) {
-                            /* Physical Counter Load Emulation (With Rescaling) */
-                            /* Rewrite MRS with B to trampoline */
-                            *instruction = instructions::B((end - patch) + offset, true).raw;
-
-                            /* Rescale host clock */
-                            std::memcpy(patch, reinterpret_cast<void *>(&guest::RescaleClock), guest::RescaleClockSize * sizeof(u32));
-                            patch += guest::RescaleClockSize;
-
-                            /* Load result from stack into destination register */
-                            instructions::Ldr ldr(0xF94003E0); // LDR XOUT, [SP]
-                            ldr.destReg = mrs.destReg;
-                            *patch++ = ldr.raw;
-
-                            /* Free 32B stack allocation by RescaleClock and Return */
-                            *patch++ = {0x910083FF}; // ADD SP, SP, #32
-                            *patch = instructions::B((end - patch) + offset + 1).raw;
-                            patch++;
-                        } else if (mrs.srcReg == CntfrqEl0) {
-                            /* Physical Counter Frequency Load Emulation */
-                            /* Rewrite MRS with B to trampoline */
-                            *instruction = instructions::B((end - patch) + offset, true).raw;
-
-                            /* Write back Tegra X1 Counter Frequency and Return */
-                            for (const auto &mov : instructions::MoveRegister(registers::X(mrs.destReg), TegraX1Freq))
-                                *patch++ = mov;
-                            *patch = instructions::B((end - patch) + offset + 1).raw;
-                            patch++;
-                        }
-                    } else if (mrs.srcReg == CntpctEl0) {
-                        /* Physical Counter Load Emulation (Without Rescaling) */
-                        // We just convert CNTPCT_EL0 -> CNTVCT_EL0 as Linux doesn't allow access to the physical counter
-                        *instruction = instructions::Mrs(CntvctEl0, registers::X(mrs.destReg)).raw;
-                    }
-                }
-            } else if (msr.Verify() && msr.destReg == TpidrEl0) {
-                /* Emulated TLS Register Store */
-                /* Rewrite MSR with B to trampoline */
-                *instruction = instructions::B((end - patch) + offset, true).raw;
-
-                /* Allocate Scratch Registers */
-                bool x0x1{mrs.srcReg != registers::X0 && mrs.srcReg != registers::X1};
-                *patch++ = x0x1 ? 0xA9BF07E0 : 0xA9BF0FE2; // STP X(0/2), X(1/3), [SP, #-16]!
-
-                /* Store new TLS value into ThreadContext */
-                *patch++ = x0x1 ? 0xD53BD040 : 0xD53BD042; // MRS X(0/2), TPIDR_EL0
-                *patch++ = instructions::Mov(x0x1 ? registers::X1 : registers::X3, registers::X(msr.srcReg)).raw;
-                *patch++ = x0x1 ? 0xF9015C01 : 0xF9015C03; // STR X(1/3), [X0, #0x4B8] (ThreadContext::tpidrEl0)
-
-                /* Restore Scratch Registers and Return */
-                *patch++ = x0x1 ? 0xA8C107E0 : 0xA8C10FE2; // LDP X(0/2), X(1/3), [SP], #16
-                *patch = instructions::B((end - patch) + offset + 1).raw;
-                patch++;
-            }
+        // The trampolines are written in chunks in parallel
+        auto instructions{reinterpret_cast<u32 *>(text.data())};
+        size_t chunkCount{GetChunkCount(offsets.size(), PatchChunkSize)};
+
+        #ifndef NDEBUG
+        std::vector<u8> serialText;
+        if (chunkCount > 1)
+            serialText = text;
+        #endif
+
+        auto patchEnd{WriteTrampolines(instructions, start, end, offsets, rescaleClock, chunkCount)};
+
+        #ifndef NDEBUG
+        if (chunkCount > 1) {
+            // Debug builds verify that the chunked patcher writes exactly what the serial patcher would, the serial one writes into copies of the same layout
+            std::vector<u32> serialPatch(static_cast<size_t>(end - start));
+            auto serialPatchEnd{WriteTrampolines(reinterpret_cast<u32 *>(serialText.data()), serialPatch.data(), serialPatch.data() + serialPatch.size(), offsets, rescaleClock, 1)};
+            if (serialPatchEnd - serialPatch.data() != patchEnd - start || !std::equal(start + MainSvcTrampolineSize, patchEnd, serialPatch.data() + MainSvcTrampolineSize) || serialText != text)
+                throw exception("PatchCode: Chunked patching differs from serial patching for 0x{:X} instructions", offsets.size());
         }
+        #endif
     }
 }
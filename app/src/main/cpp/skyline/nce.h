@@ -5,6 +5,7 @@
 
 #include "common.h"
 #include <sys/wait.h>
+#include "kernel/svc_statistics.h"
 
 namespace skyline::nce {
     /**
@@ -17,6 +18,8 @@ namespace skyline::nce {
         static void SvcHandler(u16 svcId, ThreadContext *ctx);
 
       public:
+        kernel::svc::SvcStatistics svcStatistics; //!< Call counts and latencies of all SVCs handled by SvcHandler
+
         static void SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls);
 
         NCE(const DeviceState &state);
@@ -31,6 +34,7 @@ namespace skyline::nce {
         /**
          * @brief Writes the .patch section and mutates the code accordingly
          * @param patch A pointer to the .patch section which should be exactly patchSize in size and located before the .text section
+         * @note The main SVC trampoline contains host addresses and is always written, an empty set of offsets can be supplied to only write it
          */
         static void PatchCode(std::vector<u8> &text, u32 *patch, size_t patchSize, const std::vector<size_t> &offsets);
     };
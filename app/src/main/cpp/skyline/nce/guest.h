@@ -92,7 +92,7 @@ namespace skyline {
          * @note It's stored in TPIDR_EL0 while running the guest
          */
         struct ThreadContext {
-            GpRegisters gpr;
+            GpRegisters gpr; //!< The registers used by the current SVC for arguments and results, the rest of them aren't saved and will be stale
             FpRegisters fpr;
             u8 *hostTpidrEl0; //!< Host TLS TPIDR_EL0, this must be swapped to prior to calling any CXX functions
             u8 *hostSp; //!< Host Stack Pointer, same as above
@@ -100,25 +100,14 @@ namespace skyline {
             u8 *tpidrEl0; //!< Emulated HOS TPIDR_EL0
             const DeviceState *state;
             u64 magic{constant::SkyTlsMagic};
+            u64 threadId; //!< The ID of the guest thread, this is used by SVC fast paths
+            const i8 *coreId; //!< A pointer to the core that the guest thread is running on, this is used by SVC fast paths
+            const u8 *priority; //!< A pointer to the priority of the guest thread including priority-inheritance, this is used by SVC fast paths
         };
 
         namespace guest {
-            constexpr size_t SaveCtxSize{39}; //!< The size of the SaveCtx function in 32-bit ARMv8 instructions
-            constexpr size_t LoadCtxSize{39}; //!< The size of the LoadCtx function in 32-bit ARMv8 instructions
             constexpr size_t RescaleClockSize{16}; //!< The size of the RescaleClock function in 32-bit ARMv8 instructions
 
-            /**
-             * @brief Saves the context from CPU registers into TLS
-             * @note Assumes that 8B is reserved at an offset of 8B from SP
-             */
-            extern "C" void SaveCtx(void);
-
-            /**
-             * @brief Loads the context from TLS into CPU registers
-             * @note Assumes that 8B is reserved at an offset of 8B from SP
-             */
-            extern "C" void LoadCtx(void);
-
             /**
              * @brief Rescales the host clock to Tegra X1 levels
              * @note Output is on stack with the stack pointer offset 32B from the initial point
@@ -338,5 +338,36 @@ namespace skyline::nce {
             };
         };
         static_assert(sizeof(Ldr) == sizeof(u32));
+
+        /**
+         * @brief A load or store of a pair of 64-bit registers at a signed offset from a base register without any writeback
+         * @url https://developer.arm.com/docs/ddi0596/e/base-instructions-alphabetic-order/stp-store-pair-of-registers
+         * @url https://developer.arm.com/docs/ddi0596/e/base-instructions-alphabetic-order/ldp-load-pair-of-registers
+         */
+        struct LoadStorePair {
+          public:
+            /**
+             * @param load If this is a LDP instruction rather than a STP instruction
+             * @param offset The offset from the base register in bytes, it must be a multiple of 8
+             */
+            constexpr LoadStorePair(bool load, registers::X reg1, registers::X reg2, registers::X baseReg, i16 offset) : reg1(static_cast<u8>(reg1)), baseReg(static_cast<u8>(baseReg)), reg2(static_cast<u8>(reg2)), imm(static_cast<u8>(offset / 8)), load(load), sig(0x152) {}
+
+            constexpr bool Verify() {
+                return (sig == 0x152);
+            }
+
+            union {
+                struct __attribute__((packed)) {
+                    u8 reg1 : 5; //!< 5-bit first register
+                    u8 baseReg : 5; //!< 5-bit base register
+                    u8 reg2 : 5; //!< 5-bit second register
+                    u8 imm : 7; //!< 7-bit signed immediate offset in 8 byte units
+                    u8 load : 1; //!< 1-bit flag for if the instruction is a load or a store
+                    u16 sig : 9; //!< 9-bit signature (0x152)
+                };
+                u32 raw{};
+            };
+        };
+        static_assert(sizeof(LoadStorePair) == sizeof(u32));
     }
 }
@@ -3,8 +3,10 @@
 
 #include "nce.h"
 #include "nce/guest.h"
+#include "kernel/profiler.h"
 #include "kernel/types/KProcess.h"
 #include "vfs/os_backing.h"
+#include "vfs/cached_backing.h"
 #include "loader/nro.h"
 #include "loader/nso.h"
 #include "loader/nca.h"
@@ -16,8 +18,9 @@ namespace skyline::kernel {
     OS::OS(std::shared_ptr<JvmManager> &jvmManager, std::shared_ptr<Logger> &logger, std::shared_ptr<Settings> &settings, std::string appFilesPath, std::string deviceTimeZone, std::shared_ptr<vfs::FileSystem> assetFileSystem) : state(this, jvmManager, settings, logger), appFilesPath(std::move(appFilesPath)), deviceTimeZone(std::move(deviceTimeZone)), assetFileSystem(std::move(assetFileSystem)), serviceManager(state) {}
 
     void OS::Execute(int romFd, loader::RomFormat romType) {
-        auto romFile{std::make_shared<vfs::OsBacking>(romFd)};
+        auto romFile{std::make_shared<vfs::OsBacking>(romFd, false, vfs::Backing::Mode{true, false, false}, true)}; // The ROM is never modified by us while it's being executed, it's only mapped if no other application can truncate it
         auto keyStore{std::make_shared<crypto::KeyStore>(appFilesPath)};
+        size_t romFsCacheSize{static_cast<size_t>(state.settings->romFsCacheSize) * 0x100000};
 
         state.loader = [&]() -> std::shared_ptr<loader::Loader> {
             switch (romType) {
@@ -26,11 +29,11 @@ namespace skyline::kernel {
                 case loader::RomFormat::NSO:
                     return std::make_shared<loader::NsoLoader>(std::move(romFile));
                 case loader::RomFormat::NCA:
-                    return std::make_shared<loader::NcaLoader>(std::move(romFile), std::move(keyStore));
+                    return std::make_shared<loader::NcaLoader>(std::move(romFile), std::move(keyStore), romFsCacheSize);
                 case loader::RomFormat::NSP:
-                    return std::make_shared<loader::NspLoader>(romFile, keyStore);
+                    return std::make_shared<loader::NspLoader>(romFile, keyStore, romFsCacheSize);
                 case loader::RomFormat::XCI:
-                    return std::make_shared<loader::XciLoader>(romFile, keyStore);
+                    return std::make_shared<loader::XciLoader>(romFile, keyStore, romFsCacheSize);
                 default:
                     throw exception("Unsupported ROM extension.");
             }
@@ -46,5 +49,22 @@ namespace skyline::kernel {
             thread->Start(true);
             process->Kill(true, true, true);
         }
+
+        state.nce->svcStatistics.Dump(*state.logger);
+        serviceManager.ipcStatistics.Dump(*state.logger);
+        accounting::Dump(*state.logger);
+        state.logger->Info("Resident Guest Memory: {:.2f} MiB", static_cast<double>(process->memory.GetResidentMemoryUsage()) / 0x100000);
+        if (state.profiler->Enabled()) {
+            try {
+                state.profiler->Dump(appFilesPath + "/profile.pb");
+            } catch (const std::exception &e) {
+                state.logger->Warn("Failed to write the guest profile: {}", e.what());
+            }
+        }
+        if (auto cachedRomFs{std::dynamic_pointer_cast<vfs::CachedBacking>(state.loader->romFs)})
+            cachedRomFs->Dump(*state.logger);
+        #ifdef SKYLINE_LOCK_PROFILING
+        LockSite::Dump(*state.logger);
+        #endif
     }
 }
@@ -19,7 +19,7 @@ namespace skyline::service {
         return name;
     }
 
-    Result service::BaseService::HandleRequest(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+    Result service::BaseService::HandleRequest(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response, const char *&functionName) {
         ServiceFunctionDescriptor function;
         try {
             function = GetServiceFunction(request.payload->value);
@@ -29,6 +29,7 @@ namespace skyline::service {
             return {};
         }
         TRACE_EVENT("service", perfetto::StaticString{function.name});
+        functionName = function.name;
         try {
             return function(session, request, response);
         } catch (const std::exception &e) {
@@ -83,7 +83,8 @@ namespace skyline::service {
 
         /**
          * @brief Handles an IPC Request to a service
+         * @param functionName This is set to the static name of the service function that handled the request, it's left untouched if there's no such function
          */
-        Result HandleRequest(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+        Result HandleRequest(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response, const char *&functionName);
     };
 }
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "ipc_statistics.h"
+
+namespace skyline::service {
+    void IpcStatistics::Record(const char *name, u64 parse, u64 handler, u64 write) {
+        CommandStatistics *statistics{};
+        {
+            std::shared_lock lock(mutex);
+            auto it{commands.find(name)};
+            if (it != commands.end())
+                statistics = it->second.get();
+        }
+
+        if (!statistics) [[unlikely]] {
+            std::unique_lock lock(mutex);
+            auto &entry{commands[name]};
+            if (!entry)
+                entry = std::make_unique<CommandStatistics>();
+            statistics = entry.get();
+        }
+
+        statistics->parse.Record(parse);
+        statistics->handler.Record(handler);
+        statistics->write.Record(write);
+    }
+
+    void IpcStatistics::Dump(Logger &logger) {
+        struct Entry {
+            const char *name;
+            LatencyHistogram::Snapshot parse, handler, write;
+        };
+
+        std::vector<Entry> entries;
+        {
+            std::shared_lock lock(mutex);
+            entries.reserve(commands.size());
+            for (const auto &[name, statistics] : commands)
+                entries.push_back({name, statistics->parse.GetSnapshot(), statistics->handler.GetSnapshot(), statistics->write.GetSnapshot()});
+        }
+
+        if (entries.empty())
+            return;
+
+        auto TotalTime{[](const Entry &entry) { return entry.parse.total + entry.handler.total + entry.write.total; }};
+        std::sort(entries.begin(), entries.end(), [&](const Entry &a, const Entry &b) { return TotalTime(a) > TotalTime(b); });
+
+        std::string statistics;
+        for (const auto &entry : entries)
+            statistics += fmt::format("\n* {}: {} calls, Total: {}ms, Handler Mean: {}ns, Handler P99: <{}ns, Handler Max: {}ns, Parse Mean: {}ns, Write Mean: {}ns", entry.name, entry.handler.count, TotalTime(entry) / constant::NsInMillisecond, entry.handler.Mean(), entry.handler.Percentile(99), entry.handler.max, entry.parse.Mean(), entry.write.Mean());
+        logger.Info("IPC Statistics:{}", statistics);
+    }
+}
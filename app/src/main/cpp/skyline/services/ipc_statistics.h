@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common/histogram.h>
+
+namespace skyline::service {
+    /**
+     * @brief Latency statistics for every service command that has been called, they're keyed by the name of the service function
+     */
+    class IpcStatistics {
+      public:
+        /**
+         * @brief The latencies of all stages of handling a single service command
+         */
+        struct CommandStatistics {
+            LatencyHistogram parse; //!< The time taken to parse the IPC request
+            LatencyHistogram handler; //!< The time taken by the HLE implementation of the command
+            LatencyHistogram write; //!< The time taken to write the IPC response
+        };
+
+      private:
+        std::shared_mutex mutex; //!< Synchronizes access to 'commands', it's only locked exclusively when a command is called for the first time
+        std::unordered_map<const char *, std::unique_ptr<CommandStatistics>> commands; //!< A map from the static "Class::Function" name of a service function to its statistics
+
+      public:
+        /**
+         * @brief Records the latencies of a single call to a service command, all latencies are in nanoseconds
+         * @param name The static name of the service function from its ServiceFunctionDescriptor
+         */
+        void Record(const char *name, u64 parse, u64 handler, u64 write);
+
+        /**
+         * @brief Writes the statistics of all commands to the log sorted by their total time, this can be called at any point during emulation
+         */
+        void Dump(Logger &logger);
+    };
+}
@@ -33,6 +33,8 @@ namespace skyline::service::pl {
         constexpr u32 SharedFontMagic{0x36F81A1E}; //!< The encrypted magic for a single font in the shared font data
         constexpr u32 SharedFontKey{SharedFontMagic ^ SharedFontResult}; //!< The XOR key for encrypting the font size
 
+        fontSharedMem->hostAllocation.SetCategory(accounting::Category::Fonts);
+
         auto ptr{reinterpret_cast<u32 *>(fontSharedMem->host.ptr)};
         for (auto &font : fontTable) {
             *ptr++ = SharedFontResult;
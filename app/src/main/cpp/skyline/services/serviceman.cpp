@@ -159,12 +159,15 @@ namespace skyline::service {
         state.logger->Verbose("Handle is 0x{:X}", handle);
 
         if (session->isOpen) {
+            auto parseStart{util::GetTimeNs()};
             ipc::IpcRequest request(session->isDomain, state);
             ipc::IpcResponse response(state);
+            auto handlerStart{util::GetTimeNs()};
 
             switch (request.header->type) {
                 case ipc::CommandType::Request:
-                case ipc::CommandType::RequestWithContext:
+                case ipc::CommandType::RequestWithContext: {
+                    const char *functionName{};
                     if (session->isDomain) {
                         try {
                             auto service{session->domains.at(request.domain->objectId)};
@@ -172,7 +175,7 @@ namespace skyline::service {
                                 throw exception("Domain request used an expired handle");
                             switch (request.domain->command) {
                                 case ipc::DomainCommand::SendMessage:
-                                    response.errorCode = service->HandleRequest(*session, request, response);
+                                    response.errorCode = service->HandleRequest(*session, request, response, functionName);
                                     break;
 
                                 case ipc::DomainCommand::CloseVHandle:
@@ -186,10 +189,15 @@ namespace skyline::service {
                             throw exception("Invalid object ID was used with domain request");
                         }
                     } else {
-                        response.errorCode = session->serviceObject->HandleRequest(*session, request, response);
+                        response.errorCode = session->serviceObject->HandleRequest(*session, request, response, functionName);
                     }
+
+                    auto writeStart{util::GetTimeNs()};
                     response.WriteResponse(session->isDomain);
+                    if (functionName)
+                        ipcStatistics.Record(functionName, handlerStart - parseStart, writeStart - handlerStart, util::GetTimeNs() - writeStart);
                     break;
+                }
 
                 case ipc::CommandType::Control:
                 case ipc::CommandType::ControlWithContext:
@@ -5,6 +5,7 @@
 
 #include <kernel/types/KSession.h>
 #include "base_service.h"
+#include "ipc_statistics.h"
 
 namespace skyline::service {
     /**
@@ -19,11 +20,12 @@ namespace skyline::service {
       private:
         const DeviceState &state;
         std::unordered_map<ServiceName, std::shared_ptr<BaseService>> serviceMap; //!< A mapping from a Service to the underlying object
-        std::mutex mutex; //!< Synchronizes concurrent access to services to prevent crashes
+        ProfiledMutex mutex{LOCK_SITE("ServiceManager::mutex")}; //!< Synchronizes concurrent access to services to prevent crashes
 
       public:
         std::shared_ptr<BaseService> smUserInterface; //!< Used by applications to open connections to services
         std::shared_ptr<GlobalServiceState> globalServiceState;
+        IpcStatistics ipcStatistics; //!< Latency statistics for all service commands handled by SyncRequestHandler
 
         ServiceManager(const DeviceState &state);
 
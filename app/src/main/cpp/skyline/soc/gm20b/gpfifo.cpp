@@ -107,6 +107,7 @@ namespace skyline::soc::gm20b {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, signal::ExceptionalSignalHandler);
             pushBuffers->Process([this](GpEntry gpEntry) {
                 state.logger->Debug("Processing pushbuffer: 0x{:X}", gpEntry.Address());
+                TRACE_EVENT_INSTANT("gpu", "GpfifoDepth", depthTrack, "Depth", pushBuffers->Size());
                 Process(gpEntry);
             });
         } catch (const signal::SignalException &e) {
@@ -124,6 +125,7 @@ namespace skyline::soc::gm20b {
 
     void GPFIFO::Push(span<GpEntry> entries) {
         pushBuffers->Append(entries);
+        TRACE_EVENT_INSTANT("gpu", "GpfifoDepth", depthTrack, "Depth", pushBuffers->Size());
     }
 
     GPFIFO::~GPFIFO() {
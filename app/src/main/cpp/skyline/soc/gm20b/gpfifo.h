@@ -4,6 +4,7 @@
 #pragma once
 
 #include <common/circular_queue.h>
+#include <common/trace.h>
 #include "engines/gpfifo.h"
 
 namespace skyline::soc::gm20b {
@@ -134,6 +135,7 @@ namespace skyline::soc::gm20b {
         std::optional<CircularQueue<GpEntry>> pushBuffers;
         std::thread thread; //!< The thread that manages processing of pushbuffers
         std::vector<u32> pushBufferData; //!< Persistent vector storing pushbuffer data to avoid constant reallocations
+        perfetto::Track depthTrack; //!< Perfetto track for the amount of pending GP entries, this is recorded on every push and prior to processing every entry
 
         /**
          * @brief Sends a method call to the GPU hardware
@@ -146,7 +148,7 @@ namespace skyline::soc::gm20b {
         void Process(GpEntry gpEntry);
 
       public:
-        GPFIFO(const DeviceState &state) : state(state), gpfifoEngine(state) {}
+        GPFIFO(const DeviceState &state) : state(state), gpfifoEngine(state), depthTrack(trace::CreateTrack(trace::TrackIds::GpfifoDepth, "GPFIFO Depth")) {}
 
         ~GPFIFO();
 
@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include <common.h>
+#include <common/lock_profiler.h>
 
 namespace skyline::soc::gmmu {
     enum class ChunkState {
@@ -36,7 +36,7 @@ namespace skyline::soc::gmmu {
       private:
         const DeviceState &state;
         std::vector<ChunkDescriptor> chunks;
-        std::shared_mutex mutex;
+        ProfiledSharedMutex mutex{LOCK_SITE("GraphicsMemoryManager::mutex")};
 
         /**
          * @brief Finds a chunk in the virtual address space that is larger than meets the given requirements
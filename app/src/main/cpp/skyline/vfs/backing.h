@@ -21,6 +21,13 @@ namespace skyline::vfs {
             throw exception("This backing does not support being resized");
         }
 
+        /**
+         * @return A span over the supplied range of the backing's contents in memory or an empty span if the backing doesn't support direct access
+         */
+        virtual span<const u8> GetSpanImpl(size_t offset, size_t size) {
+            return {};
+        }
+
       public:
         union Mode {
             struct {
@@ -99,6 +106,22 @@ namespace skyline::vfs {
             return object;
         }
 
+        /**
+         * @brief Provides zero-copy access to a range of the backing, this is only supported by backings which hold their contents in memory such as memory-mapped files
+         * @param offset The offset of the range in the backing
+         * @param pSize The size of the range in bytes
+         * @return A span over the range which is valid for as long as the backing is alive, or an empty span if direct access isn't supported in which case Read should be used
+         */
+        span<const u8> GetSpan(size_t offset, size_t pSize) {
+            if (!mode.read)
+                throw exception("Attempting to read a backing that is not readable");
+
+            if (offset > size || (size - offset) < pSize)
+                throw exception("Trying to access past the end of a backing: 0x{:X}/0x{:X} (Offset: 0x{:X})", pSize, size, offset);
+
+            return GetSpanImpl(offset, pSize);
+        }
+
         /**
          * @brief Writes from a buffer to a particular offset in the backing
          * @param input The data to write to the backing
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "cached_backing.h"
+
+namespace skyline::vfs {
+    CachedBacking::CachedBacking(std::shared_ptr<Backing> pBacking, size_t blockSize, size_t budget) : Backing({true, false, false}, pBacking->size), backing(std::move(pBacking)), blockSize(blockSize) {
+        if (!blockSize || (blockSize & (blockSize - 1)))
+            throw exception("CachedBacking block size must be a power of 2: 0x{:X}", blockSize);
+
+        shardCapacity = std::max<size_t>(budget / blockSize / ShardCount, 1);
+        bypassSize = std::max(budget / 4, blockSize);
+    }
+
+    size_t CachedBacking::ReadBlock(size_t index, span<u8> output, size_t offset) {
+        auto &shard{shards[index % ShardCount]};
+        auto CopyBlock{[&](const Block &block) -> size_t {
+            if (block.data.size() <= offset)
+                return 0;
+            size_t length{std::min(output.size(), block.data.size() - offset)};
+            std::memcpy(output.data(), block.data.data() + offset, length);
+            return length;
+        }};
+
+        {
+            std::scoped_lock lock{shard.mutex};
+            auto it{shard.lookup.find(index)};
+            if (it != shard.lookup.end()) {
+                shard.blocks.splice(shard.blocks.begin(), shard.blocks, it->second);
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return CopyBlock(*it->second);
+            }
+        }
+
+        // The block is read without holding the shard lock so other blocks in the shard can be accessed meanwhile, if another thread reads the same block concurrently then only one copy is retained
+        misses.fetch_add(1, std::memory_order_relaxed);
+        Block block{index, std::vector<u8>(std::min(blockSize, size - (index * blockSize)))};
+        size_t read{backing->ReadUnchecked(block.data, index * blockSize)};
+        if (read != block.data.size()) {
+            block.data.resize(read);
+            return CopyBlock(block); // Partially read blocks aren't cached as the next read of them might succeed
+        }
+
+        std::scoped_lock lock{shard.mutex};
+        auto it{shard.lookup.find(index)};
+        if (it != shard.lookup.end()) {
+            shard.blocks.splice(shard.blocks.begin(), shard.blocks, it->second);
+            return CopyBlock(*it->second);
+        }
+
+        while (shard.blocks.size() >= shardCapacity) {
+            auto &evicted{shard.blocks.back()};
+            shard.cachedSize -= evicted.data.size();
+            shard.lookup.erase(evicted.index);
+            shard.blocks.pop_back();
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        shard.cachedSize += block.data.size();
+        shard.allocation.Resize(shard.cachedSize);
+        shard.blocks.push_front(std::move(block));
+        shard.lookup.emplace(index, shard.blocks.begin());
+
+        return CopyBlock(shard.blocks.front());
+    }
+
+    size_t CachedBacking::ReadImpl(span<u8> output, size_t offset) {
+        if (offset >= size)
+            return 0;
+        if (output.size() > size - offset)
+            output = output.first(size - offset);
+
+        if (output.size() >= bypassSize) {
+            bypasses.fetch_add(1, std::memory_order_relaxed);
+            return backing->ReadUnchecked(output, offset);
+        }
+
+        size_t read{};
+        while (read < output.size()) {
+            size_t position{offset + read};
+            size_t blockOffset{position & (blockSize - 1)};
+            size_t length{std::min(output.size() - read, blockSize - blockOffset)};
+
+            size_t copied{ReadBlock(position / blockSize, output.subspan(read, length), blockOffset)};
+            read += copied;
+            if (copied != length)
+                break;
+        }
+
+        #ifndef NDEBUG
+        {
+            // Debug builds verify that reads through the cache return exactly what a direct read of the underlying backing would
+            std::vector<u8> direct(output.size());
+            size_t directRead{backing->ReadUnchecked(direct, offset)};
+            if (directRead != read || !std::equal(output.begin(), output.begin() + static_cast<ssize_t>(read), direct.begin()))
+                throw exception("CachedBacking: Cached read differs from a direct read: 0x{:X}/0x{:X} bytes (Offset: 0x{:X})", read, directRead, offset);
+        }
+        #endif
+
+        return read;
+    }
+
+    CachedBacking::Statistics CachedBacking::GetStatistics() {
+        return {
+            .hits = hits.load(std::memory_order_relaxed),
+            .misses = misses.load(std::memory_order_relaxed),
+            .evictions = evictions.load(std::memory_order_relaxed),
+            .bypasses = bypasses.load(std::memory_order_relaxed),
+        };
+    }
+
+    void CachedBacking::Dump(Logger &logger) {
+        auto statistics{GetStatistics()};
+        auto lookups{statistics.hits + statistics.misses};
+        if (!lookups && !statistics.bypasses)
+            return;
+
+        logger.Info("Cached Backing: Hits: {} ({:.1f}%), Misses: {}, Evictions: {}, Bypassed Reads: {}", statistics.hits, lookups ? (static_cast<double>(statistics.hits) * 100) / lookups : 0.0, statistics.misses, statistics.evictions, statistics.bypasses);
+    }
+}
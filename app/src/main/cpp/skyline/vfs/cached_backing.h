@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <list>
+#include <common/memory_accounting.h>
+#include "backing.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief A read-only backing which keeps an LRU cache of aligned blocks read from an underlying backing, this avoids redoing expensive work such as decryption when the same data is reread
+     * @note The cache is split into shards which are locked independently, readers of blocks in different shards don't contend with each other
+     * @note Debug builds compare every cached read against a direct read of the underlying backing, this defeats the purpose of the cache and should be kept in mind when profiling them
+     */
+    class CachedBacking : public Backing {
+      public:
+        /**
+         * @brief The statistics of all reads from a CachedBacking since its creation
+         */
+        struct Statistics {
+            u64 hits; //!< The amount of blocks which were read from the cache
+            u64 misses; //!< The amount of blocks which had to be read from the underlying backing
+            u64 evictions; //!< The amount of blocks which were evicted from the cache to make space for other blocks
+            u64 bypasses; //!< The amount of reads which were too large to be cached and went to the underlying backing directly
+        };
+
+      private:
+        static constexpr size_t ShardCount{16}; //!< The amount of independently locked shards, blocks are assigned to shards based on their index
+
+        struct Block {
+            size_t index; //!< The index of the block in the backing
+            std::vector<u8> data;
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::list<Block> blocks; //!< The cached blocks ordered from the most recently used to the least recently used
+            std::unordered_map<size_t, std::list<Block>::iterator> lookup; //!< A map from the index of a block to its entry in the list
+            size_t cachedSize{}; //!< The total size of all cached blocks in the shard
+            accounting::Allocation allocation{accounting::Category::FileCache};
+        };
+
+        std::shared_ptr<Backing> backing;
+        size_t blockSize; //!< The size of a single block, this must be a power of 2
+        size_t shardCapacity; //!< The maximum amount of blocks cached in a single shard
+        size_t bypassSize; //!< The size at which reads bypass the cache, caching them would evict most of the cache for data that's unlikely to be reread
+        std::array<Shard, ShardCount> shards;
+
+        std::atomic<u64> hits{};
+        std::atomic<u64> misses{};
+        std::atomic<u64> evictions{};
+        std::atomic<u64> bypasses{};
+
+        /**
+         * @brief Copies a part of a block into the output, the block is read from the underlying backing and inserted into the cache if it isn't cached
+         * @param offset The offset of the data to copy within the block
+         * @return The amount of bytes copied, this will be less than the output size if the underlying backing couldn't be read
+         */
+        size_t ReadBlock(size_t index, span<u8> output, size_t offset);
+
+      protected:
+        size_t ReadImpl(span<u8> output, size_t offset) override;
+
+      public:
+        /**
+         * @param blockSize The size of a cached block, this must be a power of 2
+         * @param budget The maximum amount of memory used by cached blocks in bytes
+         */
+        CachedBacking(std::shared_ptr<Backing> backing, size_t blockSize, size_t budget);
+
+        Statistics GetStatistics();
+
+        /**
+         * @brief Logs the statistics of the cache if it has been read from
+         */
+        void Dump(Logger &logger);
+    };
+}
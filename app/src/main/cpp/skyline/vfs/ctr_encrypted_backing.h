@@ -3,27 +3,22 @@
 
 #pragma once
 
-#include <crypto/aes_cipher.h>
+#include <crypto/aes_ctr_cipher.h>
 #include <crypto/key_store.h>
 #include "backing.h"
 
 namespace skyline::vfs {
     /**
      * @brief A backing for decrypting AES-CTR data
+     * @note Reads are stateless as the counter is derived from the offset, any amount of threads can read concurrently
      */
     class CtrEncryptedBacking : public Backing {
       private:
-        crypto::KeyStore::Key128 ctr;
-        crypto::AesCipher cipher;
+        crypto::KeyStore::Key128 ctr; //!< The initial counter block, the lower 64 bits are replaced by the block index of the offset into the file
+        crypto::AesCtrCipher cipher;
         std::shared_ptr<Backing> backing;
-        std::mutex mutex; //!< Synchronize all AES-CTR cipher state modifications
         size_t baseOffset; //!< The offset of the backing into the file is used to calculate the IV
 
-        /**
-         * @brief Calculates IV based on the offset
-         */
-        void UpdateCtr(u64 offset);
-
       protected:
         size_t ReadImpl(span<u8> output, size_t offset) override;
 
@@ -5,6 +5,7 @@
 #include <loader/loader.h>
 
 #include "ctr_encrypted_backing.h"
+#include "cached_backing.h"
 #include "region_backing.h"
 #include "partition_filesystem.h"
 #include "nca.h"
@@ -14,7 +15,7 @@
 namespace skyline::vfs {
     using namespace loader;
 
-    NCA::NCA(std::shared_ptr<vfs::Backing> pBacking, std::shared_ptr<crypto::KeyStore> pKeyStore, bool pUseKeyArea) : backing(std::move(pBacking)), keyStore(std::move(pKeyStore)), useKeyArea(pUseKeyArea) {
+    NCA::NCA(std::shared_ptr<vfs::Backing> pBacking, std::shared_ptr<crypto::KeyStore> pKeyStore, bool pUseKeyArea, size_t pRomFsCacheSize) : backing(std::move(pBacking)), keyStore(std::move(pKeyStore)), useKeyArea(pUseKeyArea), romFsCacheSize(pRomFsCacheSize) {
         header = backing->Read<NcaHeader>();
 
         if (header.magic != util::MakeMagic<u32>("NCA3")) {
@@ -66,10 +67,11 @@ namespace skyline::vfs {
         size_t offset{static_cast<size_t>(entry.startOffset) * constant::MediaUnitSize + sectionHeader.integrityHashInfo.levels.back().offset};
         size_t size{sectionHeader.integrityHashInfo.levels.back().size};
 
-        romFs = CreateBacking(sectionHeader, std::make_shared<RegionBacking>(backing, offset, size), offset);
+        // Only the RomFS of a program is read by the guest throughout its execution, control and data NCAs are read once if at all and shouldn't take up the cache budget
+        romFs = CreateBacking(sectionHeader, std::make_shared<RegionBacking>(backing, offset, size), offset, contentType == NcaContentType::Program ? romFsCacheSize : 0);
     }
 
-    std::shared_ptr<Backing> NCA::CreateBacking(const NcaSectionHeader &sectionHeader, std::shared_ptr<Backing> rawBacking, size_t offset) {
+    std::shared_ptr<Backing> NCA::CreateBacking(const NcaSectionHeader &sectionHeader, std::shared_ptr<Backing> rawBacking, size_t offset, size_t cacheSize) {
         if (!encrypted)
             return rawBacking;
 
@@ -86,7 +88,10 @@ namespace skyline::vfs {
                 std::memcpy(ctr.data(), &secureValueLE, 4);
                 std::memcpy(ctr.data() + 4, &generationLE, 4);
 
-                return std::make_shared<CtrEncryptedBacking>(ctr, key, std::move(rawBacking), offset);
+                auto decryptedBacking{std::make_shared<CtrEncryptedBacking>(ctr, key, std::move(rawBacking), offset)};
+                if (cacheSize) // Only decrypted sections are cached as rereading raw data is cheap in comparison
+                    return std::make_shared<CachedBacking>(std::move(decryptedBacking), constant::RomFsCacheBlockSize, cacheSize);
+                return decryptedBacking;
             }
             default:
                 return nullptr;
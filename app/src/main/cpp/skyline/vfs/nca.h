@@ -10,6 +10,7 @@
 namespace skyline {
     namespace constant {
         constexpr size_t MediaUnitSize{0x200}; //!< The unit size of entries in an NCA
+        constexpr size_t RomFsCacheBlockSize{0x4000}; //!< The size of blocks cached from a decrypted RomFS, this matches the block size commonly used by the hierarchical integrity scheme of RomFS sections
     }
 
     namespace vfs {
@@ -174,12 +175,16 @@ namespace skyline {
             bool encrypted{false};
             bool rightsIdEmpty;
             bool useKeyArea;
+            size_t romFsCacheSize; //!< The memory budget of the cache for decrypted RomFS data in bytes, 0 disables caching, it's only used for program NCAs
 
             void ReadPfs0(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry);
 
             void ReadRomFs(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry);
 
-            std::shared_ptr<Backing> CreateBacking(const NcaSectionHeader &sectionHeader, std::shared_ptr<Backing> rawBacking, size_t offset);
+            /**
+             * @param cacheSize The memory budget of a CachedBacking wrapping the decrypted section in bytes, 0 doesn't cache the section
+             */
+            std::shared_ptr<Backing> CreateBacking(const NcaSectionHeader &sectionHeader, std::shared_ptr<Backing> rawBacking, size_t offset, size_t cacheSize = 0);
 
             u8 GetKeyGeneration();
 
@@ -194,7 +199,11 @@ namespace skyline {
             std::shared_ptr<Backing> romFs; //!< The backing for this NCA's RomFS section
             NcaContentType contentType; //!< The content type of the NCA
 
-            NCA(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore, bool useKeyArea = false);
+            /**
+             * @param romFsCacheSize The memory budget of the cache for decrypted RomFS data in bytes, 0 disables caching
+             * @note The RomFS is only cached for program NCAs so a loader can pass the same budget to every NCA it opens without it being multiplied
+             */
+            NCA(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore, bool useKeyArea = false, size_t romFsCacheSize = 0);
         };
     }
 }
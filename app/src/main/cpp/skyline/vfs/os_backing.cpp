@@ -3,24 +3,59 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include "os_backing.h"
 
 namespace skyline::vfs {
-    OsBacking::OsBacking(int fd, bool closable, Mode mode) : Backing(mode), fd(fd), closable(closable) {
+    /**
+     * @return If the file is a regular file which can only be truncated or written to by our own process, this excludes files owned by other UIDs and files on FUSE
+     */
+    static bool IsPrivateFile(int fd, const struct stat &fileInfo) {
+        // Files owned by other UIDs such as those in shared storage can be truncated by their owner at any time, only files owned by our UID are guaranteed to not be truncated by anyone other than ourselves
+        if (!S_ISREG(fileInfo.st_mode) || fileInfo.st_uid != getuid())
+            return false;
+
+        // Files on FUSE filesystems such as the one backing shared storage are served by a daemon which can truncate them regardless of the owner it reports
+        struct statfs filesystemInfo;
+        return !fstatfs(fd, &filesystemInfo) && filesystemInfo.f_type != FUSE_SUPER_MAGIC;
+    }
+
+    OsBacking::OsBacking(int fd, bool closable, Mode mode, bool immutable) : Backing(mode), fd(fd), closable(closable) {
         struct stat fileInfo;
         if (fstat(fd, &fileInfo))
             throw exception("Failed to stat fd: {}", strerror(errno));
 
         size = fileInfo.st_size;
+
+        // Only immutable files are mapped, this fails for FDs that don't support mmap such as pipes in which case all reads go through pread64
+        if (immutable && !mode.write && !mode.append && size && IsPrivateFile(fd, fileInfo)) {
+            auto pointer{mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)};
+            if (pointer != MAP_FAILED) {
+                mapping = static_cast<u8 *>(pointer);
+                madvise(mapping, size, MADV_RANDOM); // Reads from the mapping are small and scattered such as headers and RomFS metadata, readahead would mostly fault in unused pages
+            }
+        }
     }
 
     OsBacking::~OsBacking() {
+        if (mapping)
+            munmap(mapping, size);
         if (closable)
             close(fd);
     }
 
     size_t OsBacking::ReadImpl(span<u8> output, size_t offset) {
+        if (mapping && output.size() <= MappedReadLimit) {
+            if (offset >= size)
+                return 0;
+            size_t length{std::min(output.size(), size - offset)};
+            std::memcpy(output.data(), mapping + offset, length);
+            return length;
+        }
+
         auto ret{pread64(fd, output.data(), output.size(), offset)};
         if (ret < 0)
             throw exception("Failed to read from fd: {}", strerror(errno));
@@ -36,6 +71,17 @@ namespace skyline::vfs {
         return static_cast<size_t>(ret);
     }
 
+    span<const u8> OsBacking::GetSpanImpl(size_t offset, size_t size) {
+        if (!mapping)
+            return {};
+
+        // Consumers of spans generally process the entire range, so it's paged in ahead of time rather than faulting on each page
+        auto alignedOffset{util::AlignDown(offset, PAGE_SIZE)};
+        madvise(mapping + alignedOffset, size + (offset - alignedOffset), MADV_WILLNEED);
+
+        return span<const u8>{mapping + offset, size};
+    }
+
     void OsBacking::ResizeImpl(size_t pSize) {
         int ret{ftruncate(fd, pSize)};
         if (ret < 0)
@@ -8,11 +8,16 @@
 namespace skyline::vfs {
     /**
      * @brief The OsBacking class provides the backing abstractions for a physical linux file
+     * @note Immutable files are memory-mapped when possible, small reads are served from the mapping without a syscall and GetSpan provides zero-copy access to the file
+     * @note Only regular files owned by our UID which aren't on FUSE are mapped, the files opened through the Storage Access Framework are generally not so these are read with pread64
      */
     class OsBacking : public Backing {
       private:
+        static constexpr size_t MappedReadLimit{0x10000}; //!< The largest read that's copied from the mapping, larger reads use pread64 as the kernel's readahead on it is faster than faulting in pages one at a time
+
         int fd; //!< An FD to the backing
         bool closable; //!< Whether the FD can be closed when the backing is destroyed
+        u8 *mapping{}; //!< A read-only mapping of the entire file, this is nullptr if the file isn't immutable or couldn't be mapped
 
       protected:
         size_t ReadImpl(span<u8> output, size_t offset) override;
@@ -21,11 +26,16 @@ namespace skyline::vfs {
 
         void ResizeImpl(size_t size) override;
 
+        span<const u8> GetSpanImpl(size_t offset, size_t size) override;
+
       public:
         /**
          * @param fd The file descriptor of the backing
+         * @param immutable If the file is read-only and guaranteed to not be truncated or written to by anything else while the backing exists, it's memory-mapped if so and it's a private file
+         * @note Files which may be truncated externally must not be mapped as accessing the mapping past the end of the file would raise SIGBUS, this applies to GetSpan consumers such as NSO decompression as well as reads
+         * @note The file being private only excludes other applications, anything else in our process truncating the file or a privileged process doing so would still raise SIGBUS
          */
-        OsBacking(int fd, bool closable = false, Mode = {true, false, false});
+        OsBacking(int fd, bool closable = false, Mode = {true, false, false}, bool immutable = false);
 
         ~OsBacking();
     };
@@ -14,6 +14,7 @@ import android.net.Uri
 import android.os.*
 import android.util.Log
 import android.view.*
+import android.widget.Toast
 import androidx.appcompat.app.AppCompatActivity
 import androidx.core.view.isGone
 import androidx.core.view.isInvisible
@@ -77,6 +78,19 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
      */
     private external fun stopEmulation() : Boolean
 
+    /**
+     * Writes the contents of the in-process trace ring buffer to a file in the app files directory
+     *
+     * @return If the trace was successfully written, this fails if the trace recorder is disabled
+     * @note This is blocking and will stall till the trace has been written, it shouldn't be called on the UI thread
+     */
+    private external fun dumpTrace() : Boolean
+
+    /**
+     * If a trace is currently being dumped by [dumpTrace], this is only accessed on the UI thread
+     */
+    private var dumpingTrace = false
+
     /**
      * This sets the surface object in libskyline to the provided value, emulation is halted if set to null
      *
@@ -209,6 +223,21 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
                         postDelayed(this, 250)
                     }
                 }, 250)
+
+                setOnLongClickListener {
+                    // Dumping the trace writes out the entire ring buffer, it's done on a separate thread to avoid stalling the UI thread
+                    if (!dumpingTrace) {
+                        dumpingTrace = true
+                        Thread {
+                            val dumped = dumpTrace()
+                            runOnUiThread {
+                                dumpingTrace = false
+                                Toast.makeText(context, if (dumped) R.string.trace_dumped else R.string.trace_dump_failed, Toast.LENGTH_SHORT).show()
+                            }
+                        }.start()
+                    }
+                    true
+                }
             }
         }
 